@@ -1,3 +1,6 @@
+#ifdef __linux__
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -5,49 +8,387 @@
 #include <string.h>
 #include <math.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define RESULTS_FILE "csv/sorting_result.csv"
 #define SEARCH_RESULTS_FILE "csv/searching_result.csv"
+#define RESULTS_LOG "csv/results.log"
+#define SNAPSHOT_DIR "cache"
+
+// datasets kept loaded by the registry, pooled working buffers, and the huge page size the
+// anonymous mappings are rounded to with --hugepages
+#define DATASET_REGISTRY_SIZE 16
+#define WORK_BUFFERS 4
+#define HUGE_PAGE_SIZE (2u << 20)
 #define DATOS10K "data/datos_10k.txt"
 #define DATOS100K "data/datos_100k.txt"
 #define DATOS1M "data/datos_1M.txt"
 #define MAX_ALGORITHMS 10
 #define MAX_NAME_LENGTH 50
+#define MAX_LIST_ITEMS 32
+#define MAX_PATH_LENGTH 256
+
+// binary dataset format: 64 byte header followed by the int32 payload (see DatasetHeader)
+#define DATASET_MAGIC "SSADATA1"
+#define DATASET_VERSION 1
+#define DATASET_TYPE_INT32 1
+#define DATASET_HEADER_SIZE 64
+#define DATASET_BINARY_EXT ".bin"
+// query files reuse the dataset header with their own magic
+#define QUERY_MAGIC "SSAQRY01"
+#define QUERY_FORMAT_VERSION 1
+
+// generator settings
+#define GENERATOR_MIN_KEY 10000000
+#define GENERATOR_KEY_RANGE 90000000ULL
+#define GENERATOR_LINE_LENGTH 9
+#define GENERATOR_BLOCK (1 << 20)
+#define GENERATOR_TEXT_HEADER_MAX 64
+
+// input distributions: nearly sorted swaps NEARLY_SORTED_SWAPS pairs per 1000 elements, few unique
+// draws from FEW_UNIQUE_KEYS keys and zipf keys follow exponent DISTRIBUTION_ZIPF_S
+#define NEARLY_SORTED_SWAPS 10
+#define FEW_UNIQUE_KEYS 16
+#define DISTRIBUTION_ZIPF_S 1.0
+#define MAX_THREADS 256
+
+// results store: kinds of entry in the log and initial size of the in-memory index
+#define RESULT_KIND_SORT 0
+#define RESULT_KIND_SEARCH 1
+#define RESULT_KIND_BUILD 2 // lookup structure builds, kept in the log only
+#define RESULT_LOG_FIELDS 21
+#define RESULT_LOG_FIELDS_V2 20 // logs written before the bytes per element column
+#define RESULT_LOG_FIELDS_V1 18 // logs written before the estimate intervals
+#define RESULT_INDEX_INITIAL 256
+
+// timing defaults, the budget stops further repetitions of slow algorithms (bubble 100k...)
+#define DEFAULT_REPETITIONS 5
+#define DEFAULT_WARMUPS 1
+#define DEFAULT_SEARCH_QUERIES 1000000
+#define DEFAULT_TIME_BUDGET 10.0
+
+// search workloads: query mix defaults, queries between budget checks (fewer in cold mode, where
+// the caches are flushed before each chunk) and the size of the buffer that flushes them
+#define DEFAULT_HIT_RATIO 0.9
+#define DEFAULT_HOT_RATIO 0.0
+#define DEFAULT_HOT_KEYS 64
+#define SEARCH_CHUNK 4096
+#define SEARCH_COLD_CHUNK 1024
+#define SEARCH_FLUSH_BYTES (64 << 20)
+
+// latency histogram, hdrhistogram style: 2^HIST_SUB_BITS linear buckets per power of two of
+// nanoseconds (~3% resolution) up to 2^HIST_MAX_BITS ns
+#define HIST_SUB_BITS 5
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_MAX_BITS 40
+#define HIST_BUCKETS (HIST_SUB + (HIST_MAX_BITS - HIST_SUB_BITS) * HIST_SUB)
+
+// complexity fitting: prefix sizes start at FIT_MIN_SIZE and grow by sqrt(2), the series stops
+// after the first point slower than FIT_POINT_BUDGET seconds. Above the MAX_MEASURED sizes the quadratic
+// and worse sorts are extrapolated instead of run
+#define FIT_MIN_SIZE 256
+#define FIT_RATIO 1.41421356
+#define FIT_MAX_POINTS 24
+#define FIT_POINT_BUDGET 2.0
+#define BUBBLE_MAX_MEASURED 100000
+#define STOOGE_MAX_MEASURED 10000
+#define QUICK_ADVERSARIAL_MAX_MEASURED 32768 // quick sort on inputs that defeat its middle pivot
+
+// radix sort digits: 4 passes of 8 bits over 32-bit keys
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+#define RADIX_PASSES 4
+#define RADIX_SIGN_FLIP 0x80000000u
+#define RADIX_SIGN_FLIP64 0x8000000000000000ull
+// parallel radix: write-combining buffer of one cache line per bucket, and a minimum slice per thread
+#define RADIX_WC_ELEMS (64 / (int)sizeof(int))
+#define RADIX_MIN_PER_THREAD 65536
+
+// the typed sorts centre the 8 digit keys on TYPED_KEY_CENTER, int64 keys are also scaled
+#define TYPED_KEY_CENTER 55000000
+#define TYPED_KEY_SCALE 1000003
+
+// merge sort: ranges up to the cutoff are insertion sorted, and each thread gets a minimum slice
+#define MERGE_SORT_CUTOFF 32
+#define MERGE_MIN_PER_THREAD 16384
+
+// introsort: insertion sort below the threshold, ninther pivot above NINTHER_MIN elements
+#define INTROSORT_THRESHOLD 16
+#define INTROSORT_NINTHER_MIN 128
+
+// parallel quicksort: ranges below the grain are sorted sequentially, ranges with more than
+// PARTITION_GRAINS grains per thread are partitioned by all threads during the first levels
+#define PQUICK_GRAIN 16384
+#define PQUICK_PARTITION_GRAINS 2
+#define PQUICK_DEQUE_CAPACITY 1024
+#define PQUICK_MAX_RANGES (2 * MAX_THREADS)
+
+// bitonic stages with pairs inside a block of this many ints (16 KiB) run without barriers
+#define BITONIC_BLOCK 4096
+
+// linear scans: the parallel scan checks for cancellation every LINEAR_BLOCK elements and only
+// splits arrays of at least LINEAR_PARALLEL_MIN
+#define LINEAR_BLOCK 16384
+#define LINEAR_PARALLEL_MIN (1 << 16)
+
+// eytzinger search prefetches the node 4 levels down: 16 ints, one cache line
+#define EYTZINGER_PREFETCH_SPAN 16
+
+// s-tree: keys per node (one cache line), layers at most (the first line holds their offsets),
+// lookups walked down together by the batch lookup
+#define STREE_B 16
+#define STREE_MAX_HEIGHT (STREE_B - 1)
+#define STREE_BATCH 16
+
+// interpolation search falls back to binary search below INTERPOLATION_MIN_RANGE elements or after
+// more than INTERPOLATION_SLOW_PROBES probes that did not halve the range
+#define INTERPOLATION_MIN_RANGE 16
+#define INTERPOLATION_SLOW_PROBES 2
+
+// radix spline: positions are predicted within RS_MAX_ERROR, the radix table has at most
+// 2^RS_MAX_RADIX_BITS slots
+#define RS_MAX_ERROR 32
+#define RS_MAX_RADIX_BITS 20
+
+// the skewed comparison maps the key range through t^SEARCH_SKEW_POWER
+#define SEARCH_SKEW_POWER 4
+
+// hash index: control bytes matched per group, load kept under 7/8, partitions for the parallel
+// build, and a bloom filter of 8 words per block at about 12 bits per key
+#define HASH_GROUP 16
+#define HASH_EMPTY 0x80
+#define HASH_MAX_LOAD_NUM 7
+#define HASH_MAX_LOAD_DEN 8
+#define HASH_PARALLEL_MIN (1 << 16)
+#define HASH_PARTITIONS_PER_THREAD 4
+#define HASH_MAX_PARTITION_BITS 10
+#define BLOOM_WORDS 8
+#define BLOOM_BITS_PER_KEY 12
+
+// progress reporter sampling period, and how many units a thread batches before touching the counter
+#define PROGRESS_INTERVAL_MS 100
+#define PROGRESS_BATCH 4096
+
+// exit codes for the batch mode
+#define EXIT_BENCH_FAILURE 1
+#define EXIT_USAGE 2
 
 // struct declarations
-typedef struct {
-    int *arr;
-    int low;
-    int cnt;
-    int dir;
-    int *progress;
-    int total_elements;
-} BitonicParams;
-
 typedef struct {
     char algorithm[MAX_NAME_LENGTH];
     int size;
     double time;
 } SortResult;
 
+// on-disk header of the binary datasets, the payload starts at payload_offset (64 byte aligned)
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t elem_type;
+    uint32_t elem_size;
+    uint32_t payload_offset;
+    uint64_t count;
+    uint64_t seed;
+    uint64_t checksum;
+    uint8_t reserved[16];
+} DatasetHeader;
+_Static_assert(sizeof(DatasetHeader) == DATASET_HEADER_SIZE, "DatasetHeader must stay 64 bytes");
+
+// a loaded dataset, data points into a read-only mapping for binary files or to the heap for text
+typedef struct {
+    int *data;
+    int n;
+    uint64_t seed;
+    uint64_t checksum;
+    void *map;
+    size_t map_len;
+} Dataset;
+
+// summary of the timed repetitions of one algorithm on one input, times in seconds.
+// reps == 0 marks an estimate that was not measured, ci_low/ci_high is its 95% interval
+typedef struct {
+    int reps;
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double mean;
+    double stddev;
+    double ns_per_element;
+    int threads;
+    double ci_low;
+    double ci_high;
+    double bytes_per_element; // memory a built structure keeps per element, 0 for everything else
+} TimingStats;
+
+typedef void (*SortKernel)(int *arr, int n);
+typedef int (*SearchKernel)(const int *arr, int n, int goal);
+
+// run settings, the menu uses the defaults and the batch mode fills them from argv
+typedef struct {
+    int repetitions;
+    int warmups;
+    int search_queries;
+    double time_budget;
+    int use_tsc;
+    uint64_t seed;
+    int seed_set;
+    int threads;
+    int binary_datasets;
+    const char *results_file;
+    const char *search_results_file;
+    int map_populate;
+    int map_hugepages;
+    int verify_checksum;
+    int pin_threads;
+    const char *results_log;
+    double hit_ratio;
+    double hot_ratio;
+    int hot_keys;
+    int search_cold;
+    const char *cache_dir; // sorted snapshots and query files, NULL keeps them in memory only
+    double zipf;           // > 0: the hits follow zipf(zipf) over the keys instead of the hot set
+    int queries_sorted;
+} BenchConfig;
+
+typedef int (*SortMeasureFn)(int *arr, int n);
+typedef int (*SearchMeasureFn)(int *arr, int n, int goal);
+
+// every benchmarkable algorithm lives in one of these tables, the menus and the cli read from them
+typedef struct {
+    const char *key;   // name used on the command line
+    const char *name;  // name stored in the results csv
+    SortMeasureFn measure;
+} SortAlgorithm;
+
+typedef struct {
+    const char *key;
+    const char *name;
+    const char *label; // text shown in the menu
+    int needs_sorted;
+    SearchMeasureFn measure;
+} SearchAlgorithm;
+
 // Function declarations
-void generateFileOfNumbers(const char *numbers, int n);
+int generateFileOfNumbers(const char *numbers, int n);
 int *loadArrayFromFile(const char *filename, int *n);
 int checkFileExists(const char *filename);
-void measure_bubble_sort(int *arr, int n);
-void measure_quick_sort(int *arr, int n);
-void measure_stooge_sort(int *arr, int n);
-void measure_radix_sort(int *arr, int n);
-void measure_merge_sort(int *arr, int n);
-void measure_bitonic_sort(int *arr, int n);
-void measure_linear_search(int *arr, int n, int goal);
-void measure_binary_search(int *arr, int n, int goal);
-void measure_ternary_search(int *arr, int n, int goal);
-void measure_jumping_search(int *arr, int n, int goal);
+int dataset_open(const char *path, Dataset *ds);
+void dataset_close(Dataset *ds);
+int convert_text_dataset(const char *path);
+int results_export(void);
+int measure_bubble_sort(int *arr, int n);
+int measure_quick_sort(int *arr, int n);
+int measure_introsort(int *arr, int n);
+int measure_parallel_quick_sort(int *arr, int n);
+void parallel_radix_sort(int *arr, int n, int num_threads);
+const int *sorted_snapshot_get(const int *arr, int n);
+void insertion_sort(int *arr, int n);
+int compare_ints(const void *a, const void *b);
+int measure_stooge_sort(int *arr, int n);
+int measure_radix_sort(int *arr, int n);
+int measure_parallel_radix_sort(int *arr, int n);
+int measure_typed_sorts(int *arr, int n);
+int measure_merge_sort(int *arr, int n);
+int measure_parallel_merge_sort(int *arr, int n);
+int measure_bitonic_sort(int *arr, int n);
+int measure_linear_search(int *arr, int n, int goal);
+int measure_simd_linear_search(int *arr, int n, int goal);
+int measure_parallel_linear_search(int *arr, int n, int goal);
+int measure_binary_search(int *arr, int n, int goal);
+int measure_ternary_search(int *arr, int n, int goal);
+int measure_jumping_search(int *arr, int n, int goal);
+int measure_eytzinger_search(int *arr, int n, int goal);
+int measure_branchless_search(int *arr, int n, int goal);
+int measure_typed_searches(int *arr, int n, int goal);
+int measure_stree_search(int *arr, int n, int goal);
+int measure_interpolation_search(int *arr, int n, int goal);
+int measure_learned_search(int *arr, int n, int goal);
+int measure_hash_search(int *arr, int n, int goal);
+int measure_bloom_hash_search(int *arr, int n, int goal);
 void fileFiller();
 void sortingBenchmark();
 void searchBenchmark();
 void menu();
+int run_batch(int argc, char **argv);
+
+// thread count the parallel kernels use for the current measurement
+static int kernel_threads = 1;
+// thread count the last parallel kernel really ran with after its own caps (size, pool), the
+// timers reset it to 1 and the stats store it
+static int kernel_threads_used = 1;
+
+static BenchConfig config = {DEFAULT_REPETITIONS, DEFAULT_WARMUPS, DEFAULT_SEARCH_QUERIES, DEFAULT_TIME_BUDGET, 0,
+                             0, 0, 1, 0, RESULTS_FILE, SEARCH_RESULTS_FILE, 0, 0, 0, 0,
+                             RESULTS_LOG, DEFAULT_HIT_RATIO, DEFAULT_HOT_RATIO, DEFAULT_HOT_KEYS, 0, SNAPSHOT_DIR, 0.0, 0};
+
+static const SortAlgorithm sort_algorithms[] = {
+    {"bubble", "Bubble Sort", measure_bubble_sort},
+    {"quick", "Quick Sort", measure_quick_sort},
+    {"intro", "Introsort", measure_introsort},
+    {"pquick", "Parallel Quick Sort", measure_parallel_quick_sort},
+    {"stooge", "Stooge Sort", measure_stooge_sort},
+    {"radix", "Radix Sort", measure_radix_sort},
+    {"pradix", "Parallel Radix Sort", measure_parallel_radix_sort},
+    {"typed", "Typed Radix Sort", measure_typed_sorts},
+    {"merge", "Merge Sort", measure_merge_sort},
+    {"pmerge", "Parallel Merge Sort", measure_parallel_merge_sort},
+    {"bitonic", "Bitonic Sort", measure_bitonic_sort},
+};
+#define NUM_SORT_ALGORITHMS ((int)(sizeof(sort_algorithms) / sizeof(sort_algorithms[0])))
+
+static const SearchAlgorithm search_algorithms[] = {
+    {"linear", "Linear Search", "Búsqueda Lineal", 0, measure_linear_search},
+    {"simd", "SIMD Linear Search", "Búsqueda Lineal SIMD", 0, measure_simd_linear_search},
+    {"plinear", "Parallel Linear Search", "Búsqueda Lineal Paralela", 0, measure_parallel_linear_search},
+    {"hash", "Hash Index Search", "Índice Hash", 0, measure_hash_search},
+    {"bloomhash", "Bloom + Hash Index Search", "Índice Hash con Filtro Bloom", 0, measure_bloom_hash_search},
+    {"binary", "Binary Search", "Búsqueda Binaria (requiere array ordenado)", 1, measure_binary_search},
+    {"ternary", "Ternary Search", "Búsqueda Ternaria (requiere array ordenado)", 1, measure_ternary_search},
+    {"jump", "Jumping Search", "Búsqueda por Saltos", 1, measure_jumping_search},
+    {"branchless", "Branchless Binary Search", "Búsqueda Binaria sin Saltos", 1, measure_branchless_search},
+    {"typedsearch", "Typed Lower Bound", "Búsqueda Tipada (lower bound de los tipos del radix tipado)", 1, measure_typed_searches},
+    {"eytzinger", "Eytzinger Search", "Búsqueda Eytzinger", 1, measure_eytzinger_search},
+    {"stree", "S-Tree Search", "Búsqueda en Árbol S", 1, measure_stree_search},
+    {"interpolation", "Interpolation Search", "Búsqueda por Interpolación", 1, measure_interpolation_search},
+    {"learned", "Learned Index Search", "Índice Aprendido (Radix Spline)", 1, measure_learned_search},
+};
+#define NUM_SEARCH_ALGORITHMS ((int)(sizeof(search_algorithms) / sizeof(search_algorithms[0])))
+
+// kernels report work through PROGRESS_ADD only, see the progress section below
+#ifndef BENCH_NO_PROGRESS
+static atomic_llong progress_work;
+static _Thread_local long long progress_pending;
+
+static inline void progress_add(long long units) {
+    progress_pending += units;
+    if (progress_pending >= PROGRESS_BATCH) {
+        atomic_fetch_add_explicit(&progress_work, progress_pending, memory_order_relaxed);
+        progress_pending = 0;
+    }
+}
+
+// the counter is per thread: a pool task hands its remainder over before the thread moves on to
+// another kernel, otherwise it would count there
+static inline void progress_flush(void) {
+    if (progress_pending == 0) return;
+    atomic_fetch_add_explicit(&progress_work, progress_pending, memory_order_relaxed);
+    progress_pending = 0;
+}
+#define PROGRESS_ADD(units) progress_add(units)
+#define PROGRESS_FLUSH() progress_flush()
+#else
+#define PROGRESS_ADD(units) ((void)0)
+#define PROGRESS_FLUSH() ((void)0)
+#endif
 
 int compare_results(const void *a, const void *b) {
     const SortResult *ra = (const SortResult *)a;
@@ -58,6 +399,7 @@ int compare_results(const void *a, const void *b) {
 }
 
 void show_results_chart_py() {
+    results_export();
     system("python3 scripts/sorting_visualization.py csv/sorting_result.csv");
     #ifdef _WIN32
         system("start sorting_results.png");
@@ -69,6 +411,7 @@ void show_results_chart_py() {
 }
 
 void show_results_search_py() {
+    results_export();
     system("python3 scripts/search_visualization.py csv/searching_result.csv");
     #ifdef _WIN32
         system("start search_results.png");
@@ -79,917 +422,5262 @@ void show_results_search_py() {
     #endif
 }
 
-void write_result(const char *algorithm, int size, double time) {
-    FILE *temp = fopen("temp_results.csv", "w");
-    FILE *original = fopen(RESULTS_FILE, "r");
-    int exists = 0;
-    // write all the entries except for the updated one
-    if (original) {
-        char line[256];
-        while (fgets(line, sizeof(line), original)) {
-            char buf_alg[50];
-            int buf_size;
-            sscanf(line, "%49[^,],%d,", buf_alg, &buf_size);
-
-            if (strcmp(buf_alg, algorithm) == 0 && buf_size == size) {
-                fprintf(temp, "%s,%d,%.6f\n", algorithm, size, time);
-                exists = 1;
-            } else {
-                fprintf(temp, "%s", line);
-            }
-        }
-        fclose(original);
-    }
+// csv columns: algorithm,size,median,min,p90,p99,stddev,ns_per_element,reps,threads,estimated,ci_low,ci_high,
+// distribution,bytes_per_element (times in seconds). The median stays in the third column so the plotting
+// scripts keep working
+#define RESULT_CSV_DISTRIBUTION_COLUMN 13
+void fprint_result_line(FILE *file, const char *algorithm, int size, const char *distribution, const TimingStats *stats) {
+    fprintf(file, "%s,%d,%.9f,%.9f,%.9f,%.9f,%.9f,%.3f,%d,%d,%d,%.9f,%.9f,%s,%.3f\n", algorithm, size, stats->median,
+            stats->min, stats->p90, stats->p99, stats->stddev, stats->ns_per_element, stats->reps, stats->threads,
+            stats->reps == 0, stats->ci_low, stats->ci_high, distribution, stats->bytes_per_element);
+}
+
+// ---------------------------------------------------------------------------
+// results store: every measurement is appended to a tab separated log (config.results_log) with
+// the run metadata, nothing is rewritten. An in-memory index keeps the latest entry per
+// (kind, algorithm, size, distribution) for the lookups of the estimates, the csv files are exports of it
+// ---------------------------------------------------------------------------
+
+#ifndef BENCH_COMPILE_FLAGS
+#define BENCH_COMPILE_FLAGS "?" // set by CMakeLists.txt
+#endif
+#if defined(__clang__)
+#define BENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define BENCH_COMPILER "gcc " __VERSION__
+#else
+#define BENCH_COMPILER "cc"
+#endif
+
+typedef struct {
+    int kind;
+    char algorithm[MAX_NAME_LENGTH];
+    int size;
+    char distribution[MAX_NAME_LENGTH];
+    TimingStats stats;
+} ResultEntry;
+
+typedef struct {
+    ResultEntry *entries; // one per key, in order of first appearance like the old csv rows
+    int count;
+    int capacity;
+    int *slots; // open addressing over entries, -1 is empty
+    int num_slots;
+    FILE *log;
+    int loaded;
+} ResultStore;
+
+// what the machine and the build look like, filled once
+typedef struct {
+    char host[64];
+    char cpu[128];
+    char compiler[256];
+    int ready;
+} RunInfo;
+
+// dataset the next results belong to, the benchmark flows set it after registry_open
+typedef struct {
+    uint64_t seed;
+    uint64_t checksum;
+    const char *distribution;
+} ResultContext;
+
+static ResultStore result_store;
+static RunInfo run_info;
+static ResultContext result_context = {0, 0, "uniform"};
+
+// files come from the uniform generator, the distribution matrix retags after this
+void results_set_dataset(const Dataset *ds) {
+    result_context.seed = ds->seed;
+    result_context.checksum = ds->checksum;
+    result_context.distribution = "uniform";
+}
 
-    if (!exists) fprintf(temp, "%s,%d,%.6f\n", algorithm, size, time);
-    fclose(temp);
-    remove(RESULTS_FILE);
-    rename("temp_results.csv", RESULTS_FILE);
+// log fields are tab separated, so tabs and newlines inside them become spaces
+void results_clean_field(char *text) {
+    for (char *p = text; *p; p++) {
+        if (*p == '\t' || *p == '\n' || *p == '\r') *p = ' ';
+    }
 }
 
-void write_search_result(const char *algorithm, int size, double time) {
-    FILE *temp = fopen("temp_search_results.csv", "w");
-    FILE *original = fopen(SEARCH_RESULTS_FILE, "r");
-    int exists = 0;
-    if (original) {
+void run_info_fill(void) {
+    if (run_info.ready) return;
+    run_info.ready = 1;
+
+    if (gethostname(run_info.host, sizeof(run_info.host)) != 0) snprintf(run_info.host, sizeof(run_info.host), "?");
+    run_info.host[sizeof(run_info.host) - 1] = '\0';
+
+    snprintf(run_info.cpu, sizeof(run_info.cpu), "?");
+    FILE *cpuinfo = fopen("/proc/cpuinfo", "r");
+    if (cpuinfo) {
         char line[256];
-        while (fgets(line, sizeof(line), original)) {
-            char buf_alg[50];
-            int buf_size;
-            sscanf(line, "%49[^,],%d,", buf_alg, &buf_size);
-
-            if (strcmp(buf_alg, algorithm) == 0 && buf_size == size) {
-                fprintf(temp, "%s,%d,%.6f\n", algorithm, size, time);
-                exists = 1;
-            } else {
-                fprintf(temp, "%s", line);
+        while (fgets(line, sizeof(line), cpuinfo)) {
+            char *colon = strchr(line, ':');
+            if (strncmp(line, "model name", 10) == 0 && colon != NULL) {
+                char *value = colon + 1;
+                while (*value == ' ') value++;
+                value[strcspn(value, "\n")] = '\0';
+                snprintf(run_info.cpu, sizeof(run_info.cpu), "%s", value);
+                break;
             }
         }
-        fclose(original);
+        fclose(cpuinfo);
     }
 
-    if (!exists) fprintf(temp, "%s,%d,%.6f\n", algorithm, size, time);
-    fclose(temp);
-    remove(SEARCH_RESULTS_FILE);
-    rename("temp_search_results.csv", SEARCH_RESULTS_FILE);
+    snprintf(run_info.compiler, sizeof(run_info.compiler), "%s %s", BENCH_COMPILER, BENCH_COMPILE_FLAGS);
+    results_clean_field(run_info.host);
+    results_clean_field(run_info.cpu);
+    results_clean_field(run_info.compiler);
 }
 
-int read_result(const char *algorithm, int size, double *time) {
-    FILE *file = fopen(RESULTS_FILE, "r");
-    if (!file) return 0;
+uint64_t result_key_hash(int kind, const char *algorithm, int size, const char *distribution) {
+    uint64_t h = 0xcbf29ce484222325ULL; // fnv-1a
+    for (const char *p = algorithm; *p; p++) h = (h ^ (unsigned char)*p) * 0x100000001b3ULL;
+    for (const char *p = distribution; *p; p++) h = (h ^ (unsigned char)*p) * 0x100000001b3ULL;
+    h = (h ^ (uint64_t)(uint32_t)size) * 0x100000001b3ULL;
+    return (h ^ (uint64_t)kind) * 0x100000001b3ULL;
+}
 
-    char line[100];
-    char saved_alg[50];
-    int saved_size;
-    double saved_time;
+// slot of the key, or of the empty slot where it would go
+int result_index_slot(int kind, const char *algorithm, int size, const char *distribution) {
+    const int mask = result_store.num_slots - 1;
+    int slot = (int)(result_key_hash(kind, algorithm, size, distribution) & (uint64_t)mask);
+    while (result_store.slots[slot] >= 0) {
+        const ResultEntry *entry = &result_store.entries[result_store.slots[slot]];
+        if (entry->kind == kind && entry->size == size && strcmp(entry->algorithm, algorithm) == 0 &&
+            strcmp(entry->distribution, distribution) == 0) break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
 
-    while (fgets(line, sizeof(line), file)) {
-        if (sscanf(line, "%49[^,],%d,%lf", saved_alg, &saved_size, &saved_time) == 3) {
-            if (strcmp(saved_alg, algorithm) == 0 && saved_size == size) {
-                *time = saved_time;
-                fclose(file);
-                return 1;
-            }
-        }
+// keeps the load factor under 1/2
+void result_index_grow(void) {
+    const int num_slots = result_store.num_slots ? result_store.num_slots * 2 : RESULT_INDEX_INITIAL;
+    int *slots = malloc(num_slots * sizeof(int));
+    if (slots == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    free(result_store.slots);
+    result_store.slots = slots;
+    result_store.num_slots = num_slots;
+    for (int i = 0; i < num_slots; i++) slots[i] = -1;
+    for (int e = 0; e < result_store.count; e++) {
+        const ResultEntry *entry = &result_store.entries[e];
+        slots[result_index_slot(entry->kind, entry->algorithm, entry->size, entry->distribution)] = e;
+    }
+}
+
+void result_index_put(int kind, const char *algorithm, int size, const char *distribution, const TimingStats *stats) {
+    if (2 * (result_store.count + 1) > result_store.num_slots) result_index_grow();
+    const int slot = result_index_slot(kind, algorithm, size, distribution);
+    if (result_store.slots[slot] >= 0) {
+        result_store.entries[result_store.slots[slot]].stats = *stats;
+        return;
     }
 
-    fclose(file);
-    return 0;
+    if (result_store.count == result_store.capacity) {
+        const int capacity = result_store.capacity ? result_store.capacity * 2 : RESULT_INDEX_INITIAL;
+        ResultEntry *entries = realloc(result_store.entries, capacity * sizeof(ResultEntry));
+        if (entries == NULL) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+        result_store.entries = entries;
+        result_store.capacity = capacity;
+    }
+    ResultEntry *entry = &result_store.entries[result_store.count];
+    entry->kind = kind;
+    snprintf(entry->algorithm, sizeof(entry->algorithm), "%s", algorithm);
+    entry->size = size;
+    snprintf(entry->distribution, sizeof(entry->distribution), "%s", distribution);
+    entry->stats = *stats;
+    result_store.slots[slot] = result_store.count++;
 }
 
-int read_search_result(const char *algorithm, int size, double *time) {
-    FILE *file = fopen(SEARCH_RESULTS_FILE, "r");
-    if (!file) return 0;
+static const char *const result_kind_names[] = {"sort", "search", "build"};
+
+// one log line; imported rows have no metadata and get "-" instead
+void results_log_append(int kind, const char *algorithm, int size, const char *distribution, const TimingStats *stats,
+                        int imported) {
+    if (result_store.log == NULL) return;
+    char timestamp[32];
+    const time_t now = time(NULL);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+    char name[MAX_NAME_LENGTH];
+    snprintf(name, sizeof(name), "%s", algorithm);
+    results_clean_field(name);
+    if (imported) {
+        fprintf(result_store.log, "%s\t%s\t-\t-\t-\t%d\t-\t-\t%s", result_kind_names[kind], timestamp, stats->threads,
+                distribution);
+    } else {
+        run_info_fill();
+        fprintf(result_store.log, "%s\t%s\t%s\t%s\t%s\t%d\t%llu\t%016llx\t%s",
+                result_kind_names[kind], timestamp, run_info.host, run_info.cpu,
+                run_info.compiler, stats->threads, (unsigned long long)result_context.seed,
+                (unsigned long long)result_context.checksum, distribution);
+    }
+    fprintf(result_store.log, "\t%s\t%d\t%.9f\t%.9f\t%.9f\t%.9f\t%.9f\t%.3f\t%d\t%.9f\t%.9f\t%.3f\n", name, size,
+            stats->median, stats->min, stats->p90, stats->p99, stats->stddev, stats->ns_per_element, stats->reps,
+            stats->ci_low, stats->ci_high, stats->bytes_per_element);
+    fflush(result_store.log);
+}
 
-    char line[100];
-    char saved_alg[50];
-    int saved_size;
-    double saved_time;
+int results_parse_log_line(char *line) {
+    char *fields[RESULT_LOG_FIELDS];
+    int count = 0;
+    char *save = NULL;
+    line[strcspn(line, "\n")] = '\0';
+    for (char *tok = strtok_r(line, "\t", &save); tok != NULL && count < RESULT_LOG_FIELDS;
+         tok = strtok_r(NULL, "\t", &save)) {
+        fields[count++] = tok;
+    }
+    if (count != RESULT_LOG_FIELDS && count != RESULT_LOG_FIELDS_V2 && count != RESULT_LOG_FIELDS_V1) return 0;
+
+    TimingStats stats;
+    memset(&stats, 0, sizeof(stats));
+    int kind = RESULT_KIND_BUILD;
+    while (kind > RESULT_KIND_SORT && strcmp(fields[0], result_kind_names[kind]) != 0) kind--;
+    stats.threads = atoi(fields[5]);
+    stats.median = stats.mean = strtod(fields[11], NULL);
+    stats.min = strtod(fields[12], NULL);
+    stats.p90 = strtod(fields[13], NULL);
+    stats.p99 = strtod(fields[14], NULL);
+    stats.stddev = strtod(fields[15], NULL);
+    stats.ns_per_element = strtod(fields[16], NULL);
+    stats.reps = atoi(fields[17]);
+    if (count >= RESULT_LOG_FIELDS_V2) {
+        stats.ci_low = strtod(fields[18], NULL);
+        stats.ci_high = strtod(fields[19], NULL);
+    }
+    if (count == RESULT_LOG_FIELDS) stats.bytes_per_element = strtod(fields[20], NULL);
+    // rows imported from csv files without the column were logged as "-", they came from the uniform files
+    result_index_put(kind, fields[9], atoi(fields[10]), strcmp(fields[8], "-") == 0 ? "uniform" : fields[8], &stats);
+    return 1;
+}
 
+// csv files from before the log: the rows go to the index and to the log so they are not lost
+// on the next export. Old rows may only have algorithm,size,time
+void results_import_csv(int kind, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) return;
+    char line[512];
     while (fgets(line, sizeof(line), file)) {
-        if (sscanf(line, "%49[^,],%d,%lf", saved_alg, &saved_size, &saved_time) == 3) {
-            if (strcmp(saved_alg, algorithm) == 0 && saved_size == size) {
-                *time = saved_time;
-                fclose(file);
-                return 1;
-            }
+        char algorithm[MAX_NAME_LENGTH];
+        int size;
+        TimingStats stats;
+        memset(&stats, 0, sizeof(stats));
+        const int fields = sscanf(line, "%49[^,],%d,%lf,%lf,%lf,%lf,%lf,%lf,%d,%d", algorithm, &size, &stats.median,
+                                  &stats.min, &stats.p90, &stats.p99, &stats.stddev, &stats.ns_per_element,
+                                  &stats.reps, &stats.threads);
+        if (fields < 3) continue;
+        if (fields < 4) stats.min = stats.p90 = stats.p99 = stats.median;
+        if (fields < 8) stats.ns_per_element = size > 0 ? stats.median * 1e9 / size : 0.0;
+        if (fields < 9) stats.reps = 1;
+        if (fields < 10) stats.threads = 1;
+        stats.mean = stats.median;
+
+        // the distribution column is the last one, older files stop before it
+        const char *distribution = line;
+        for (int commas = 0; *distribution && commas < RESULT_CSV_DISTRIBUTION_COLUMN; distribution++) {
+            if (*distribution == ',') commas++;
         }
+        char tag[MAX_NAME_LENGTH];
+        const size_t tag_length = strcspn(distribution, ",\r\n");
+        snprintf(tag, sizeof(tag), "%.*s", (int)tag_length, distribution);
+        if (tag[0] == '\0') snprintf(tag, sizeof(tag), "uniform");
+        if (distribution[tag_length] == ',') stats.bytes_per_element = strtod(distribution + tag_length + 1, NULL);
+        result_index_put(kind, algorithm, size, tag, &stats);
+        results_log_append(kind, algorithm, size, tag, &stats, 1);
     }
-
     fclose(file);
-    return 0;
 }
 
-// I need to generate 8 digit random numbers, 1 million of them. Then load those numbers in a file.
-void generateFileOfNumbers(const char *numbers, const int n) {
+// loads the log into the index on first use and keeps it open for appending
+void results_store_load(void) {
+    if (result_store.loaded) return;
+    result_store.loaded = 1;
+    result_index_grow();
+
+    FILE *existing = fopen(config.results_log, "r");
+    if (existing) {
+        char line[1024];
+        while (fgets(line, sizeof(line), existing)) {
+            if (line[0] != '#') results_parse_log_line(line);
+        }
+        fclose(existing);
+    }
 
-    FILE *result = fopen(numbers, "w");
-    if (result == NULL) {
-        printf("Error al crear el archivo\n");
-        exit(1); // Shouldn't do this, but I am toooo lazyyy
+    result_store.log = fopen(config.results_log, "a");
+    if (result_store.log == NULL) {
+        printf("Error al abrir el registro de resultados %s\n", config.results_log);
+        return;
+    }
+    if (!existing) {
+        fprintf(result_store.log, "# kind\ttimestamp\thost\tcpu\tcompiler\tthreads\tseed\tchecksum\tdistribution\t"
+                                  "algorithm\tsize\tmedian\tmin\tp90\tp99\tstddev\tns_per_element\treps\tci_low\tci_high\t"
+                                  "bytes_per_element\n");
+        results_import_csv(RESULT_KIND_SORT, config.results_file);
+        results_import_csv(RESULT_KIND_SEARCH, config.search_results_file);
     }
+}
 
-    srand(time(NULL)); // Seed for random numbers, a "key", even though it generates a predictable sequence of values
-    for (int i = 0; i < n; i++) {
-        int num = 10000000 + (rand() % 90000000);
-        fprintf(result, "%d\n", num);
+void results_record(int kind, const char *algorithm, int size, const TimingStats *stats) {
+    results_store_load();
+    result_index_put(kind, algorithm, size, result_context.distribution, stats);
+    results_log_append(kind, algorithm, size, result_context.distribution, stats, 0);
+}
+
+int results_lookup(int kind, const char *algorithm, int size, double *time) {
+    results_store_load();
+    const int slot = result_index_slot(kind, algorithm, size, result_context.distribution);
+    if (result_store.slots[slot] < 0) return 0;
+    *time = result_store.entries[result_store.slots[slot]].stats.median;
+    return 1;
+}
+
+// latest entry per key, written to a temp file first so a crash never leaves half a csv
+int results_export_csv(int kind, const char *path) {
+    results_store_load();
+    char temp_path[MAX_PATH_LENGTH];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    FILE *temp = fopen(temp_path, "w");
+    if (temp == NULL) {
+        printf("Error al escribir %s\n", temp_path);
+        return -1;
+    }
+    for (int e = 0; e < result_store.count; e++) {
+        const ResultEntry *entry = &result_store.entries[e];
+        if (entry->kind == kind) fprint_result_line(temp, entry->algorithm, entry->size, entry->distribution, &entry->stats);
     }
+    if (fclose(temp) != 0 || rename(temp_path, path) != 0) {
+        printf("Error al escribir %s\n", path);
+        return -1;
+    }
+    return 0;
+}
 
-    fclose(result);
-    printf("--------------------------------------------------\n");
-    printf("El archivo '%s' ahora tiene %d números.\n", numbers, n);
+int results_export(void) {
+    int status = results_export_csv(RESULT_KIND_SORT, config.results_file);
+    if (results_export_csv(RESULT_KIND_SEARCH, config.search_results_file) != 0) status = -1;
+    return status;
+}
+
+void results_close(void) {
+    if (result_store.log) fclose(result_store.log);
+    free(result_store.entries);
+    free(result_store.slots);
+    memset(&result_store, 0, sizeof(result_store));
+}
+
+void write_result(const char *algorithm, int size, const TimingStats *stats) {
+    results_record(RESULT_KIND_SORT, algorithm, size, stats);
+}
+
+void write_search_result(const char *algorithm, int size, const TimingStats *stats) {
+    results_record(RESULT_KIND_SEARCH, algorithm, size, stats);
+}
+
+// build costs of the search structures, neither csv exports them so the sort plots stay sorts
+void write_build_result(const char *algorithm, int size, const TimingStats *stats) {
+    results_record(RESULT_KIND_BUILD, algorithm, size, stats);
+}
+
+int read_result(const char *algorithm, int size, double *time) {
+    return results_lookup(RESULT_KIND_SORT, algorithm, size, time);
 }
 
+int read_search_result(const char *algorithm, int size, double *time) {
+    return results_lookup(RESULT_KIND_SEARCH, algorithm, size, time);
+}
+
+// text fallback: one read of the whole file and one parsing pass, no fgetc/fscanf per number
 int *loadArrayFromFile(const char *filename, int *n) {
-    FILE *file = fopen(filename, "r");
+    FILE *file = fopen(filename, "rb");
     if (file == NULL) {
         printf("Error al abrir el archivo %s\n", filename);
         return NULL;
     }
 
-    // Count number of lines
-    int count = 0;
-    char ch;
-    while ((ch = fgetc(file)) != EOF) {
-        if (ch == '\n') count++;
-    }
+    fseek(file, 0, SEEK_END);
+    const long file_size = ftell(file);
     rewind(file);
+    if (file_size < 0) {
+        printf("Error al leer el archivo %s\n", filename);
+        fclose(file);
+        return NULL;
+    }
 
-    // Allocate memory
-    int *arr = malloc(count * sizeof(int));
-    if (arr == NULL) {
+    char *text = malloc((size_t)file_size + 1);
+    if (text == NULL) {
         printf("Memory allocation failed\n");
         fclose(file);
         return NULL;
     }
+    const size_t read = fread(text, 1, (size_t)file_size, file);
+    fclose(file);
+    text[read] = '\0';
+
+    // upper bound of numbers: every number needs at least a digit and a separator
+    size_t capacity = read / 2 + 1;
+    int *arr = malloc(capacity * sizeof(int));
+    if (arr == NULL) {
+        printf("Memory allocation failed\n");
+        free(text);
+        return NULL;
+    }
 
-    // Read numbers
-    for (int i = 0; i < count; i++) {
-        if (fscanf(file, "%d", &arr[i]) != 1) {
-            printf("Error reading file at line %d\n", i+1);
+    size_t count = 0;
+    const char *p = text;
+    const char *end = text + read;
+    int line = 1;
+    while (p < end) {
+        if (*p == '\n') { line++; p++; continue; }
+        if (*p == '\r' || *p == ' ' || *p == '\t') { p++; continue; }
+        if (*p == '#') { // comment lines, e.g. generator metadata
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+
+        int negative = 0;
+        if (*p == '-') { negative = 1; p++; }
+        if (p >= end || *p < '0' || *p > '9') {
+            printf("Error reading file at line %d\n", line);
+            free(arr);
+            free(text);
+            return NULL;
+        }
+        long long value = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value = value * 10 + (*p - '0');
+            if (value > (long long)INT_MAX + 1) break;
+            p++;
+        }
+        if (negative) value = -value;
+        if (value < INT_MIN || value > INT_MAX || count == (size_t)INT_MAX) {
+            printf("Error reading file at line %d\n", line);
             free(arr);
-            fclose(file);
+            free(text);
             return NULL;
         }
+        arr[count++] = (int)value;
     }
 
-    fclose(file);
-    *n = count;
+    free(text);
+    *n = (int)count;
     return arr;
 }
 
-int checkFileExists(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (file) {
-        fclose(file);
-        return 1;
-    }
-    return 0;
+// mixes one 64-bit word (splitmix64 finalizer), shared by the checksum and the generators
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
 }
 
-void measure_bubble_sort(int *arr, int n) {
-    double time_taken;
-    const char *alg_name = "Bubble Sort";
-
-    // As 1 million is to big to iterate, just estimate
-    if (n == 1000000) {
-        double time_100k;
-
-        if (!read_result(alg_name, 100000, &time_100k)) {
-                printf("Ejecuta primero las pruebas de 100 mil elementos.\n");
-                return;
-        }
-
-        /*----------------------------------------------------------
-          Explicación de la estimación:
-          - Bubble Sort es O(n²) → Tiempo ∝ n²
-          - Relación de tamaños: 1,000,000 / 100,000 = 10
-          - Factor de escala: 10² = 100
-        ----------------------------------------------------------*/
-        double factor = 100.0;
-        time_taken = time_100k * factor;
-        write_result(alg_name, n, time_taken);
-        printf("Tamaño: %d | Tiempo estimado: %.6f segundos\n", n, time_taken);
-        return;
+// order sensitive but computed as a sum, so chunks can be checksummed independently and added up
+uint64_t dataset_checksum_range(const int *arr, size_t first, size_t count) {
+    uint64_t sum = 0;
+    for (size_t i = first; i < first + count; i++) {
+        sum += mix64(((uint64_t)i << 32) | (uint32_t)arr[i - first]);
     }
+    return sum;
+}
 
-    // Allocate memory and prepare the variables for the progress bar.
-    int *temp_arr = malloc(n * sizeof(int));
-    memcpy(temp_arr, arr, n * sizeof(int));
-
-    int total_passes = n-1; // External for iteration total
-    int update_interval = total_passes / 100; // Update every 1%
-    if (update_interval < 1) update_interval = 1;
+uint64_t dataset_checksum(const int *arr, size_t n) {
+    return dataset_checksum_range(arr, 0, n);
+}
 
-    // Start the count
-    const clock_t start = clock();
-    printf("\nProgreso: [");
-    fflush(stdout);
+void dataset_fill_header(DatasetHeader *header, uint64_t count, uint64_t seed, uint64_t checksum) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, DATASET_MAGIC, sizeof(header->magic));
+    header->version = DATASET_VERSION;
+    header->elem_type = DATASET_TYPE_INT32;
+    header->elem_size = sizeof(int);
+    header->payload_offset = DATASET_HEADER_SIZE;
+    header->count = count;
+    header->seed = seed;
+    header->checksum = checksum;
+}
 
-    // Bubble Sort
-    for (int i = 0; i < n-1; i++) {
-        // Update the progress
-        if (i % update_interval == 0) {
-            int percent = (i * 100) / total_passes;
-            printf("\rProgreso: [");
-            for (int p = 0; p < 50; p++) {
-                if (p < percent/2) printf("=");
-                else printf(" ");
-            }
-            printf("] %d%%", percent);
-            fflush(stdout);
-        }
-        // Algorithm itself
-        for (int j = 0; j < n-i-1; j++) {
-            if (temp_arr[j] > temp_arr[j+1]) {
-                int temp = temp_arr[j];
-                temp_arr[j] = temp_arr[j+1];
-                temp_arr[j+1] = temp;
-            }
-        }
+int dataset_write_binary(const char *path, const int *arr, int n, uint64_t seed) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("Error al crear el archivo %s\n", path);
+        return -1;
     }
 
-    printf("\rProgreso: [");
-    for (int p = 0; p < 50; p++) printf("=");
-    printf("] 100%%\n");
-
-    const clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-    write_result(alg_name, n, time_taken);
-    free(temp_arr);
-    printf("Tamaño: %d | Tiempo: %.6f segundos\n", n, time_taken);
+    DatasetHeader header;
+    dataset_fill_header(&header, (uint64_t)n, seed, dataset_checksum(arr, (size_t)n));
+    const int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(arr, sizeof(int), (size_t)n, file) == (size_t)n;
+    if (fclose(file) != 0 || !ok) {
+        printf("Error al escribir el archivo %s\n", path);
+        remove(path);
+        return -1;
+    }
+    return 0;
 }
 
-void quick_sort_recursive(int *arr, int left, int right, int *progress, int total_elements) {
-    if (left >= right) return;
+// data/datos_10k.txt -> data/datos_10k.bin
+void dataset_binary_path(const char *path, char *out, size_t len) {
+    const char *dot = strrchr(path, '.');
+    const char *slash = strrchr(path, '/');
+    int stem = (dot != NULL && (slash == NULL || dot > slash)) ? (int)(dot - path) : (int)strlen(path);
+    snprintf(out, len, "%.*s%s", stem, path, DATASET_BINARY_EXT);
+}
 
-    int pivot = arr[(left + right) / 2];
-    int i = left, j = right;
+int is_binary_dataset(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    char magic[8];
+    const int match = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                      memcmp(magic, DATASET_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return match;
+}
 
-    while (i <= j) {
-        while (arr[i] < pivot) i++;
-        while (arr[j] > pivot) j--;
-        if (i <= j) {
-            int temp = arr[i];
-            arr[i] = arr[j];
-            arr[j] = temp;
-            i++;
-            j--;
-        }
+int dataset_map_binary(const char *path, Dataset *ds) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Error al abrir el archivo %s\n", path);
+        return -1;
     }
 
-    // Update progress (approximation based on partitions)
-    int current_progress = (i * 100) / total_elements;
-    if (current_progress > *progress) {
-        *progress = current_progress;
-        printf("\rProgreso: [");
-        for (int p = 0; p < 50; p++) {
-            if (p < current_progress/2) printf("=");
-            else printf(" ");
-        }
-        printf("] %d%%", current_progress);
-        fflush(stdout);
+    struct stat st;
+    DatasetHeader header;
+    if (fstat(fd, &st) != 0 || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        memcmp(header.magic, DATASET_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DATASET_VERSION || header.elem_type != DATASET_TYPE_INT32 ||
+        header.elem_size != sizeof(int) || header.count > INT_MAX ||
+        (uint64_t)st.st_size < header.payload_offset + header.count * sizeof(int)) {
+        printf("Archivo binario inválido: %s\n", path);
+        close(fd);
+        return -1;
     }
 
-    quick_sort_recursive(arr, left, j, progress, total_elements);
-    quick_sort_recursive(arr, i, right, progress, total_elements);
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (config.map_populate) flags |= MAP_POPULATE;
+#endif
+    const size_t map_len = header.payload_offset + header.count * sizeof(int);
+    void *map = mmap(NULL, map_len, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("Error al mapear el archivo %s\n", path);
+        return -1;
+    }
+#ifdef MADV_HUGEPAGE
+    if (config.map_hugepages) madvise(map, map_len, MADV_HUGEPAGE);
+#endif
+
+    ds->map = map;
+    ds->map_len = map_len;
+    ds->data = (int *)((char *)map + header.payload_offset);
+    ds->n = (int)header.count;
+    ds->seed = header.seed;
+    ds->checksum = header.checksum;
+
+    if (config.verify_checksum && dataset_checksum(ds->data, (size_t)ds->n) != header.checksum) {
+        printf("Checksum incorrecto en %s\n", path);
+        dataset_close(ds);
+        return -1;
+    }
+    return 0;
 }
 
-void measure_quick_sort(int *arr, int n) {
-    double time_taken;
-    const char *alg_name = "Quick Sort";
-
-    // Create a temporary copy to preserve original array
-    int *temp_arr = malloc(n * sizeof(int));
-    if (temp_arr == NULL) {
-        printf("Memory allocation failed\n");
-        exit(1);
+// opens a dataset: binary files are mapped read-only, text files are parsed. For a text path a
+// sibling .bin that is at least as new is used instead, so converted files are picked up for free
+int dataset_open(const char *path, Dataset *ds) {
+    memset(ds, 0, sizeof(*ds));
+
+    char bin_path[MAX_PATH_LENGTH];
+    dataset_binary_path(path, bin_path, sizeof(bin_path));
+    struct stat text_st, bin_st;
+    if (strcmp(bin_path, path) != 0 && stat(bin_path, &bin_st) == 0 &&
+        (stat(path, &text_st) != 0 || bin_st.st_mtime >= text_st.st_mtime) && is_binary_dataset(bin_path)) {
+        return dataset_map_binary(bin_path, ds);
     }
-    memcpy(temp_arr, arr, n * sizeof(int));
-
-    printf("\nProgreso: [");
-    for (int p = 0; p < 50; p++) printf(" ");
-    printf("] 0%%");
-    fflush(stdout);
-
-    int progress = 0;
-    clock_t start = clock();
+    if (is_binary_dataset(path)) return dataset_map_binary(path, ds);
 
-    // Call the recursive quick sort
-    quick_sort_recursive(temp_arr, 0, n-1, &progress, n);
-
-    printf("\rProgreso: [");
-    for (int p = 0; p < 50; p++) printf("=");
-    printf("] 100%%\n");
+    ds->data = loadArrayFromFile(path, &ds->n);
+    if (ds->data == NULL) return -1;
+    ds->checksum = dataset_checksum(ds->data, (size_t)ds->n);
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-    write_result(alg_name, n, time_taken);
-    free(temp_arr);
-    printf("Tamaño: %d | Tiempo: %.6f segundos\n", n, time_taken);
+    // generated text files start with "# seed=..."
+    FILE *file = fopen(path, "r");
+    unsigned long long seed;
+    if (file) {
+        if (fscanf(file, "# seed=%llu", &seed) == 1) ds->seed = seed;
+        fclose(file);
+    }
+    return 0;
 }
 
-void stooge_sort_recursive(int *arr, int l, int h, int *progress, int total_elements) {
-    if (l >= h) return;
+void dataset_close(Dataset *ds) {
+    if (ds->map != NULL) munmap(ds->map, ds->map_len);
+    else free(ds->data);
+    memset(ds, 0, sizeof(*ds));
+}
 
-    // If first element is smaller than last, swap them
-    if (arr[l] > arr[h]) {
-        int temp = arr[l];
-        arr[l] = arr[h];
-        arr[h] = temp;
-    }
+// ---------------------------------------------------------------------------
+// thread pool: the workers are created once (size from --threads, optionally pinned with --pin)
+// and sleep between jobs, so a parallel kernel only pays a wake-up instead of pthread_create.
+// pool_run is fork-join: the caller runs as worker 0 and returns when every worker is done.
+// Jobs do not nest, only the main thread submits them
+// ---------------------------------------------------------------------------
 
-    // If there are more than 2 elements in the array
-    if (h - l + 1 > 2) {
-        int t = (h - l + 1) / 3;
+typedef void (*PoolTask)(void *arg, int id, int num_threads);
 
-        // Recursively sort first 2/3 elements
-        stooge_sort_recursive(arr, l, h - t, progress, total_elements);
+typedef struct {
+    pthread_t threads[MAX_THREADS];
+    int size; // workers including the calling thread, 0 until pool_start
+    int pinned;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    unsigned long long generation; // bumped for every job
+    int shutdown;
+    PoolTask task;
+    void *arg;
+    int active;  // workers taking part in the current job
+    int pending; // of those, the ones still running (the caller excluded)
+} ThreadPool;
+
+static ThreadPool pool = {.mutex = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER,
+                          .done = PTHREAD_COND_INITIALIZER};
+
+// binds the calling thread to one cpu, round-robin over the online ones
+void pool_pin_current(int id) {
+#ifdef __linux__
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(id % (cpus > 0 ? cpus : 1)), &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        printf("No se pudo fijar el hilo %d a un núcleo\n", id);
+    }
+#else
+    (void)id;
+#endif
+}
 
-        // Recursively sort last 2/3 elements
-        stooge_sort_recursive(arr, l + t, h, progress, total_elements);
+void *pool_worker(void *arg) {
+    const int id = (int)(intptr_t)arg;
+    if (pool.pinned) pool_pin_current(id);
 
-        // Recursively sort first 2/3 elements again
-        stooge_sort_recursive(arr, l, h - t, progress, total_elements);
+    unsigned long long seen = 0;
+    pthread_mutex_lock(&pool.mutex);
+    while (1) {
+        while (pool.generation == seen && !pool.shutdown) pthread_cond_wait(&pool.wake, &pool.mutex);
+        if (pool.shutdown) break;
+        seen = pool.generation;
+        if (id >= pool.active) continue;
+
+        PoolTask task = pool.task;
+        void *task_arg = pool.arg;
+        const int active = pool.active;
+        pthread_mutex_unlock(&pool.mutex);
+        task(task_arg, id, active);
+        PROGRESS_FLUSH();
+        pthread_mutex_lock(&pool.mutex);
+        if (--pool.pending == 0) pthread_cond_signal(&pool.done);
     }
+    pthread_mutex_unlock(&pool.mutex);
+    return NULL;
+}
 
-    // Update progress (very rough approximation)
-    int current_progress = ((h - l) * 100) / total_elements;
-    if (current_progress > *progress) {
-        *progress = current_progress;
-        printf("\rProgreso: [");
-        for (int p = 0; p < 50; p++) {
-            if (p < current_progress/2) printf("=");
-            else printf(" ");
+void pool_start(int size, int pin) {
+    if (pool.size > 0) return;
+    if (size < 1) size = 1;
+    if (size > MAX_THREADS) size = MAX_THREADS;
+    pool.pinned = pin;
+    pool.shutdown = 0;
+    if (pin) pool_pin_current(0);
+
+    pool.size = 1;
+    for (int t = 1; t < size; t++) {
+        if (pthread_create(&pool.threads[t], NULL, pool_worker, (void *)(intptr_t)t) != 0) {
+            printf("No se pudieron crear más de %d hilos\n", pool.size);
+            break;
         }
-        printf("] %d%%", current_progress);
-        fflush(stdout);
+        pool.size++;
     }
 }
 
-void measure_stooge_sort(int *arr, int n) {
-    double time_taken;
-    const char *alg_name = "Stooge Sort";
-
-    // For large arrays, estimate based on 10k elements
-    if (n == 100000 || n == 1000000) {
-        double time_10k;
-
-        if (!read_result(alg_name, 10000, &time_10k)) {
-            printf("Ejecuta primero las pruebas de 10 mil elementos.\n");
-            return;
-        }
+void pool_stop(void) {
+    if (pool.size == 0) return;
+    pthread_mutex_lock(&pool.mutex);
+    pool.shutdown = 1;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.mutex);
+    for (int t = 1; t < pool.size; t++) pthread_join(pool.threads[t], NULL);
+    pool.size = 0;
+}
 
-        /*----------------------------------------------------------
-          Explicación de la estimación:
-          - Stooge Sort es O(n^2.7)
-          - Para 100,000: (100000/10000)^2.7 ≈ 10^2.7 ≈ 501
-          - Para 1,000,000: (1000000/10000)^2.7 ≈ 100^2.7 ≈ 100,000
-        ----------------------------------------------------------*/
-        double factor;
-        if (n == 100000) factor = 501.0;
-        else factor = 100000.0;
+// how many of the requested threads a job gets, kernels size their barriers with it
+int pool_threads(int requested) {
+    if (pool.size == 0) pool_start(config.threads, config.pin_threads);
+    return requested < pool.size ? requested : pool.size;
+}
 
-        time_taken = time_10k * factor;
-        write_result(alg_name, n, time_taken);
-        printf("Tamaño: %d | Tiempo estimado: %.6f segundos\n", n, time_taken);
+// runs task(arg, id, n) for every id < n, n is capped at the pool size and the caller is id 0
+void pool_run(int num_threads, PoolTask task, void *arg) {
+    num_threads = pool_threads(num_threads);
+    if (num_threads <= 1) {
+        task(arg, 0, 1);
         return;
     }
 
-    // Create a temporary copy to preserve original array
-    int *temp_arr = malloc(n * sizeof(int));
-    if (temp_arr == NULL) {
-        printf("Memory allocation failed\n");
-        exit(1);
-    }
-    memcpy(temp_arr, arr, n * sizeof(int));
+    pthread_mutex_lock(&pool.mutex);
+    pool.task = task;
+    pool.arg = arg;
+    pool.active = num_threads;
+    pool.pending = num_threads - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.mutex);
+
+    task(arg, 0, num_threads);
+    PROGRESS_FLUSH();
+
+    pthread_mutex_lock(&pool.mutex);
+    while (pool.pending > 0) pthread_cond_wait(&pool.done, &pool.mutex);
+    pthread_mutex_unlock(&pool.mutex);
+}
 
-    printf("\nProgreso: [");
-    for (int p = 0; p < 50; p++) printf(" ");
-    printf("] 0%%");
-    fflush(stdout);
+typedef struct {
+    void (*body)(void *arg, int lo, int hi);
+    void *arg;
+    int begin;
+    int end;
+} PoolRange;
+
+void pool_range_task(void *arg, int id, int num_threads) {
+    const PoolRange *range = (const PoolRange *)arg;
+    const long long len = range->end - range->begin;
+    const int lo = range->begin + (int)(len * id / num_threads);
+    const int hi = range->begin + (int)(len * (id + 1) / num_threads);
+    if (lo < hi) range->body(range->arg, lo, hi);
+}
 
-    int progress = 0;
-    clock_t start = clock();
+// splits [begin, end) in num_threads contiguous slices, body(arg, lo, hi) runs once per slice
+void pool_parallel_for(int begin, int end, int num_threads, void (*body)(void *arg, int lo, int hi), void *arg) {
+    PoolRange range = {body, arg, begin, end};
+    if (num_threads > end - begin) num_threads = end - begin;
+    if (num_threads < 1) return;
+    pool_run(num_threads, pool_range_task, &range);
+}
 
-    // Call the recursive stooge sort
-    stooge_sort_recursive(temp_arr, 0, n-1, &progress, n);
+// ---------------------------------------------------------------------------
+// dataset registry and working buffers: each dataset is loaded once per process into read-only
+// memory (binary files are already mapped that way, parsed text files are copied into an
+// anonymous mapping that is then sealed), 64 byte aligned and with huge pages on --hugepages.
+// The benchmarks copy it into working buffers taken from a small pool: they are mapped once,
+// first touched by the pool threads in the contiguous slices the parallel kernels use, and
+// handed out again to the next algorithm instead of a fresh malloc
+// ---------------------------------------------------------------------------
 
-    printf("\rProgreso: [");
-    for (int p = 0; p < 50; p++) printf("=");
-    printf("] 100%%\n");
+typedef struct {
+    time_t mtime;
+    off_t size;
+    ino_t inode;
+} FileStamp;
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-    write_result(alg_name, n, time_taken);
-    free(temp_arr);
-    printf("Tamaño: %d | Tiempo: %.6f segundos\n", n, time_taken);
-}
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+    Dataset ds;
+    FileStamp source; // the requested path and its .bin sibling, a change reloads the entry
+    FileStamp binary;
+    int used;
+} RegistryEntry;
 
-int get_max(int *arr, int n) {
-    int max = arr[0];
-    for (int i = 1; i < n; i++) {
-        if (arr[i] > max) {
-            max = arr[i];
-        }
+typedef struct {
+    int *data;
+    size_t bytes; // mapping length
+    int in_use;
+} WorkBuffer;
+
+static RegistryEntry dataset_registry[DATASET_REGISTRY_SIZE];
+static int registry_next_evict;
+static WorkBuffer work_buffers[WORK_BUFFERS];
+
+void file_stamp(const char *path, FileStamp *stamp) {
+    struct stat st;
+    memset(stamp, 0, sizeof(*stamp));
+    if (stat(path, &st) == 0) {
+        stamp->mtime = st.st_mtime;
+        stamp->size = st.st_size;
+        stamp->inode = st.st_ino;
     }
-    return max;
 }
 
-int get_min(int a, int b) {
-    if (a > b){
-        return a;
-    }
-    return b;
+// page aligned anonymous memory (so 64 byte aligned too), on huge pages when --hugepages asks
+void *map_anonymous(size_t bytes, size_t *mapped) {
+    const size_t unit = config.map_hugepages ? HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+    bytes = (bytes + unit - 1) / unit * unit;
+    if (bytes == 0) bytes = unit;
+    void *map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+    if (config.map_hugepages) madvise(map, bytes, MADV_HUGEPAGE);
+#endif
+    *mapped = bytes;
+    return map;
 }
 
-void counting_sort(int *arr, int n, int exp, int *progress, int total_passes, int current_pass) {
-    int *output = malloc(n * sizeof(int));
-    int count[10] = {0};
+// moves a parsed text dataset from the heap into a read-only mapping
+int registry_seal(Dataset *ds) {
+    size_t bytes;
+    int *map = map_anonymous((size_t)ds->n * sizeof(int), &bytes);
+    if (map == NULL) return -1;
+    memcpy(map, ds->data, (size_t)ds->n * sizeof(int));
+    mprotect(map, bytes, PROT_READ);
+    free(ds->data);
+    ds->data = map;
+    ds->map = map;
+    ds->map_len = bytes;
+    return 0;
+}
 
-    // count each digit ocurrencnes
-    for (int i = 0; i < n; i++) {
-        count[(arr[i] / exp) % 10]++;
+void registry_forget(const char *path) {
+    for (int e = 0; e < DATASET_REGISTRY_SIZE; e++) {
+        RegistryEntry *entry = &dataset_registry[e];
+        if (entry->used && strcmp(entry->path, path) == 0) {
+            dataset_close(&entry->ds);
+            entry->used = 0;
+        }
     }
+}
 
-    // changing count[i] for it to store the current pos
-    for (int i = 1; i < 10; i++) {
-        count[i] += count[i - 1];
+// the dataset of path, loaded on the first call and reused while the file stays the same.
+// The memory is read-only and owned by the registry, callers never close it
+const Dataset *registry_open(const char *path) {
+    char bin_path[MAX_PATH_LENGTH];
+    dataset_binary_path(path, bin_path, sizeof(bin_path));
+    FileStamp source, binary;
+    file_stamp(path, &source);
+    file_stamp(bin_path, &binary);
+
+    for (int e = 0; e < DATASET_REGISTRY_SIZE; e++) {
+        RegistryEntry *entry = &dataset_registry[e];
+        if (!entry->used || strcmp(entry->path, path) != 0) continue;
+        if (memcmp(&entry->source, &source, sizeof(source)) == 0 && memcmp(&entry->binary, &binary, sizeof(binary)) == 0) {
+            return &entry->ds;
+        }
+        registry_forget(path);
+        break;
     }
 
-    // build output array
-    for (int i = n - 1; i >= 0; i--) {
-        output[count[(arr[i] / exp) % 10] - 1] = arr[i];
-        count[(arr[i] / exp) % 10]--;
+    RegistryEntry *entry = NULL;
+    for (int e = 0; e < DATASET_REGISTRY_SIZE && entry == NULL; e++) {
+        if (!dataset_registry[e].used) entry = &dataset_registry[e];
     }
-
-    // copy the output array to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = output[i];
+    if (entry == NULL) {
+        entry = &dataset_registry[registry_next_evict];
+        registry_next_evict = (registry_next_evict + 1) % DATASET_REGISTRY_SIZE;
+        dataset_close(&entry->ds);
+        entry->used = 0;
     }
 
-    free(output);
+    if (dataset_open(path, &entry->ds) != 0) return NULL;
+    if (entry->ds.map == NULL && registry_seal(&entry->ds) != 0) {
+        printf("Memory allocation failed\n");
+        dataset_close(&entry->ds);
+        return NULL;
+    }
+    snprintf(entry->path, sizeof(entry->path), "%s", path);
+    entry->source = source;
+    entry->binary = binary;
+    entry->used = 1;
+    return &entry->ds;
+}
 
-    // thx gpt, update the progress
-    int current_progress = (current_pass * 100) / total_passes;
-    if (current_progress > *progress) {
-        *progress = current_progress;
-        printf("\rProgreso: [");
-        for (int p = 0; p < 50; p++) {
-            if (p < current_progress/2) printf("=");
-            else printf(" ");
-        }
-        printf("] %d%%", current_progress);
-        fflush(stdout);
+void registry_close_all(void) {
+    for (int e = 0; e < DATASET_REGISTRY_SIZE; e++) {
+        if (dataset_registry[e].used) dataset_close(&dataset_registry[e].ds);
+        dataset_registry[e].used = 0;
     }
 }
 
-void measure_radix_sort(int *arr, int n) {
-    double time_taken;
-    const char *alg_name = "Radix Sort";
+typedef struct {
+    char *base;
+    size_t page;
+} TouchRange;
+
+void work_buffer_touch(void *arg, int lo, int hi) {
+    const TouchRange *range = (const TouchRange *)arg;
+    for (int p = lo; p < hi; p++) range->base[(size_t)p * range->page] = 0;
+}
 
-    // ccreate a temporary copy to preserve original array
-    int *temp_arr = malloc(n * sizeof(int));
-    if (temp_arr == NULL) {
-        printf("Memory allocation failed\n");
-        exit(1);
+// a buffer of at least count ints, the smallest free one that fits. Without one, the smallest
+// free buffer is replaced by a new mapping, first touched on the pool threads
+int *work_buffer_get(size_t count) {
+    const size_t need = (count > 0 ? count : 1) * sizeof(int);
+    WorkBuffer *best = NULL, *spare = NULL;
+    for (int b = 0; b < WORK_BUFFERS; b++) {
+        WorkBuffer *buffer = &work_buffers[b];
+        if (buffer->in_use) continue;
+        if (buffer->bytes >= need && (best == NULL || buffer->bytes < best->bytes)) best = buffer;
+        if (spare == NULL || buffer->bytes < spare->bytes) spare = buffer;
+    }
+    if (best != NULL) {
+        best->in_use = 1;
+        return best->data;
+    }
+    if (spare == NULL) {
+        // every buffer is taken, a plain allocation still works
+        return aligned_alloc(64, (need + 63) / 64 * 64);
     }
-    memcpy(temp_arr, arr, n * sizeof(int));
 
-    printf("\nProgreso: [");
-    for (int p = 0; p < 50; p++) printf(" ");
-    printf("] 0%%");
-    fflush(stdout);
+    if (spare->data != NULL) munmap(spare->data, spare->bytes);
+    memset(spare, 0, sizeof(*spare));
+    size_t bytes;
+    int *data = map_anonymous(need, &bytes);
+    if (data == NULL) return NULL;
 
-    int progress = 0;
-    clock_t start = clock();
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    TouchRange range = {(char *)data, page};
+    pool_parallel_for(0, (int)(bytes / page), pool_threads(config.threads), work_buffer_touch, &range);
 
-    int max = get_max(temp_arr, n);
+    spare->data = data;
+    spare->bytes = bytes;
+    spare->in_use = 1;
+    return data;
+}
 
-    // not necessary to find the digit amount of the biggest element as we know is 8
-    // counting sort per digit
-    int current_pass = 0;
-    for (int exp = 1; max / exp > 0; exp *= 10) {
-        const int total_passes = 8;
-        current_pass++;
-        counting_sort(temp_arr, n, exp, &progress, total_passes, current_pass);
+void work_buffer_put(int *data) {
+    if (data == NULL) return;
+    for (int b = 0; b < WORK_BUFFERS; b++) {
+        if (work_buffers[b].data == data) {
+            work_buffers[b].in_use = 0;
+            return;
+        }
+    }
+    free(data);
+}
+
+void work_buffers_release(void) {
+    for (int b = 0; b < WORK_BUFFERS; b++) {
+        if (work_buffers[b].data != NULL) munmap(work_buffers[b].data, work_buffers[b].bytes);
+        memset(&work_buffers[b], 0, sizeof(work_buffers[b]));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// dataset generator: element i is a pure function of (seed, i), so the output is bit-identical
+// for the same seed whatever the thread count, and every thread writes its own slice with pwrite
+// ---------------------------------------------------------------------------
+
+// splitmix64 is a counter based generator, output i is mix64(seed + (i + 1) * golden gamma)
+static inline uint64_t generator_random(uint64_t seed, uint64_t i) {
+    return mix64(seed + (i + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+// 8 digit keys in [10,000,000, 99,999,999], multiply-shift instead of a biased modulo
+static inline int generator_key(uint64_t seed, uint64_t i) {
+    return GENERATOR_MIN_KEY + (int)(((generator_random(seed, i) >> 32) * GENERATOR_KEY_RANGE) >> 32);
+}
+
+// a seed for runs without --seed, mixes in nanoseconds and the pid so two runs never collide
+uint64_t generator_fresh_seed(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return mix64(((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ ((uint64_t)getpid() << 48));
+}
+
+typedef struct {
+    int fd;
+    int binary;
+    uint64_t seed;
+    size_t first;
+    size_t count;
+    size_t header_len;
+    uint64_t checksum;
+    int status;
+} GeneratorParams;
+
+void generator_task(void *arg, int id, int num_threads) {
+    (void)num_threads;
+    GeneratorParams *params = (GeneratorParams *)arg + id;
+    const size_t elem_len = params->binary ? sizeof(int) : GENERATOR_LINE_LENGTH;
+    char *buffer = malloc(GENERATOR_BLOCK * elem_len);
+    if (buffer == NULL) {
+        params->status = -1;
+        return;
+    }
+
+    uint64_t checksum = 0;
+    for (size_t done = 0; done < params->count; ) {
+        const size_t block = params->count - done < GENERATOR_BLOCK ? params->count - done : GENERATOR_BLOCK;
+        const size_t first = params->first + done;
+
+        for (size_t k = 0; k < block; k++) {
+            const int key = generator_key(params->seed, first + k);
+            if (params->binary) {
+                ((int *)buffer)[k] = key;
+                checksum += mix64(((uint64_t)(first + k) << 32) | (uint32_t)key);
+            } else {
+                // keys always have 8 digits, so every line is exactly 9 bytes long
+                char *line = buffer + k * GENERATOR_LINE_LENGTH;
+                int value = key;
+                for (int d = 7; d >= 0; d--) {
+                    line[d] = (char)('0' + value % 10);
+                    value /= 10;
+                }
+                line[8] = '\n';
+            }
+        }
+
+        const size_t len = block * elem_len;
+        off_t offset = (off_t)(params->header_len + first * elem_len);
+        for (size_t written = 0; written < len; ) {
+            const ssize_t w = pwrite(params->fd, buffer + written, len - written, offset + (off_t)written);
+            if (w <= 0) {
+                params->status = -1;
+                free(buffer);
+                return;
+            }
+            written += (size_t)w;
+        }
+        done += block;
+    }
+
+    params->checksum = checksum;
+    params->status = 0;
+    free(buffer);
+    return;
+}
+
+// writes n keys for the given seed; .bin paths get the binary format, anything else the text one
+int generate_dataset(const char *path, int n, uint64_t seed, int num_threads) {
+    const size_t dot_len = strlen(DATASET_BINARY_EXT);
+    const size_t path_len = strlen(path);
+    const int binary = path_len >= dot_len && strcmp(path + path_len - dot_len, DATASET_BINARY_EXT) == 0;
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("Error al crear el archivo\n");
+        return -1;
+    }
+
+    char text_header[GENERATOR_TEXT_HEADER_MAX];
+    size_t header_len;
+    if (binary) {
+        header_len = DATASET_HEADER_SIZE;
+    } else {
+        header_len = (size_t)snprintf(text_header, sizeof(text_header), "# seed=%llu count=%d\n",
+                                      (unsigned long long)seed, n);
+    }
+    const size_t elem_len = binary ? sizeof(int) : GENERATOR_LINE_LENGTH;
+    if (ftruncate(fd, (off_t)(header_len + (size_t)n * elem_len)) != 0) {
+        printf("Error al reservar el archivo %s\n", path);
+        close(fd);
+        return -1;
+    }
+
+    if (num_threads < 1) num_threads = 1;
+    if ((size_t)num_threads > (size_t)n / GENERATOR_BLOCK + 1) num_threads = n / GENERATOR_BLOCK + 1;
+    GeneratorParams params[MAX_THREADS];
+
+    const size_t chunk = (size_t)n / num_threads;
+    for (int t = 0; t < num_threads; t++) {
+        params[t].fd = fd;
+        params[t].binary = binary;
+        params[t].seed = seed;
+        params[t].first = t * chunk;
+        params[t].count = (t == num_threads - 1) ? (size_t)n - t * chunk : chunk;
+        params[t].header_len = header_len;
+        params[t].status = -1;
+    }
+    pool_run(num_threads, generator_task, params);
+
+    int status = 0;
+    uint64_t checksum = 0;
+    for (int t = 0; t < num_threads; t++) {
+        if (params[t].status != 0) status = -1;
+        checksum += params[t].checksum;
+    }
+
+    if (status == 0) {
+        if (binary) {
+            DatasetHeader header;
+            dataset_fill_header(&header, (uint64_t)n, seed, checksum);
+            if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) status = -1;
+        } else if (pwrite(fd, text_header, header_len, 0) != (ssize_t)header_len) {
+            status = -1;
+        }
+    }
+    if (close(fd) != 0) status = -1;
+    if (status != 0) {
+        printf("Error al escribir el archivo %s\n", path);
+        remove(path);
+    }
+    return status;
+}
+
+// I need to generate 8 digit random numbers, 1 million of them. Then load those numbers in a file.
+int generateFileOfNumbers(const char *numbers, const int n) {
+    // --seed makes the file reproducible, otherwise a fresh seed is drawn; either way it is stored in the file
+    const uint64_t seed = config.seed_set ? config.seed : generator_fresh_seed();
+
+    if (generate_dataset(numbers, n, seed, config.threads) != 0) return -1;
+    registry_forget(numbers);
+
+    printf("--------------------------------------------------\n");
+    printf("El archivo '%s' ahora tiene %d números (semilla %llu).\n", numbers, n, (unsigned long long)seed);
+    return 0;
+}
+
+// one-shot converter from the text files to the binary format, writes the .bin next to the source
+int convert_text_dataset(const char *path) {
+    int n;
+    int *arr = loadArrayFromFile(path, &n);
+    if (arr == NULL) return -1;
+
+    char bin_path[MAX_PATH_LENGTH];
+    dataset_binary_path(path, bin_path, sizeof(bin_path));
+    const int status = dataset_write_binary(bin_path, arr, n, 0);
+    free(arr);
+    if (status == 0) printf("Convertido %s -> %s (%d números)\n", path, bin_path, n);
+    return status;
+}
+
+int checkFileExists(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (file) {
+        fclose(file);
+        return 1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// timing layer: wall clock (CLOCK_MONOTONIC_RAW, or rdtsc with --tsc), N repetitions on a fresh
+// copy after the warmups, and robust statistics instead of a single clock() reading
+// ---------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#ifdef CLOCK_MONOTONIC_RAW
+#define BENCH_CLOCK CLOCK_MONOTONIC_RAW
+#else
+#define BENCH_CLOCK CLOCK_MONOTONIC
+#endif
+
+static double tsc_ns_per_tick = 0.0;
+
+static inline uint64_t clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(BENCH_CLOCK, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// measures the tsc rate against the monotonic clock over ~20ms, only needed once
+void timer_calibrate(void) {
+#ifdef HAVE_TSC
+    const uint64_t ns_start = clock_ns();
+    const uint64_t tsc_start = __rdtsc();
+    while (clock_ns() - ns_start < 20000000ULL) {}
+    const uint64_t ns_end = clock_ns();
+    const uint64_t tsc_end = __rdtsc();
+    tsc_ns_per_tick = (double)(ns_end - ns_start) / (double)(tsc_end - tsc_start);
+#else
+    config.use_tsc = 0;
+#endif
+}
+
+// timestamp in nanoseconds from the selected source
+static inline uint64_t timer_now(void) {
+#ifdef HAVE_TSC
+    if (config.use_tsc) return (uint64_t)((double)__rdtsc() * tsc_ns_per_tick);
+#endif
+    return clock_ns();
+}
+
+int compare_doubles(const void *a, const void *b) {
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank percentile on sorted samples
+double percentile_sorted(const double *sorted, int count, double q) {
+    int rank = (int)ceil(q * count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+// sorts the samples in place and fills the summary
+void compute_stats(double *samples, int count, int n, TimingStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->threads = kernel_threads_used;
+    if (count == 0) return;
+
+    qsort(samples, count, sizeof(double), compare_doubles);
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += samples[i];
+    const double mean = sum / count;
+    double sq = 0.0;
+    for (int i = 0; i < count; i++) sq += (samples[i] - mean) * (samples[i] - mean);
+
+    stats->reps = count;
+    stats->min = samples[0];
+    stats->median = (count % 2) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+    stats->p90 = percentile_sorted(samples, count, 0.90);
+    stats->p99 = percentile_sorted(samples, count, 0.99);
+    stats->mean = mean;
+    stats->stddev = count > 1 ? sqrt(sq / (count - 1)) : 0.0;
+    stats->ns_per_element = n > 0 ? stats->median * 1e9 / n : 0.0;
+}
+
+// extrapolated times are stored with reps == 0 so they can be told apart from measurements
+void estimate_stats(double time, double ci_low, double ci_high, int n, TimingStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->threads = kernel_threads_used;
+    stats->ci_low = ci_low;
+    stats->ci_high = ci_high;
+    stats->min = stats->median = stats->p90 = stats->p99 = stats->mean = time;
+    stats->ns_per_element = n > 0 ? time * 1e9 / n : 0.0;
+}
+
+void print_stats(int n, const TimingStats *stats) {
+    printf("Tamaño: %d | Mediana: %.6f s | Mín: %.6f s | p90: %.6f s | p99: %.6f s | Desv: %.6f s | %.3f ns/elem | reps: %d\n",
+           n, stats->median, stats->min, stats->p90, stats->p99, stats->stddev, stats->ns_per_element, stats->reps);
+}
+
+// ---------------------------------------------------------------------------
+// progress: the kernels only bump a relaxed atomic work counter (batched per thread), a reporter
+// thread samples it and owns all the terminal output. Building with BENCH_NO_PROGRESS removes the
+// accounting from the kernels and the reporter altogether
+// ---------------------------------------------------------------------------
+
+void print_progress_bar(int percent) {
+    printf("\rProgreso: [");
+    for (int p = 0; p < 50; p++) {
+        if (p < percent/2) printf("=");
+        else printf(" ");
+    }
+    printf("] %d%%", percent);
+    fflush(stdout);
+}
+
+#ifndef BENCH_NO_PROGRESS
+typedef struct {
+    long long total;
+    atomic_int stop;
+    pthread_t thread;
+} ProgressReporter;
+
+static ProgressReporter reporter;
+
+void *progress_reporter_thread(void *arg) {
+    (void)arg;
+    int shown = 0;
+    const struct timespec interval = {0, PROGRESS_INTERVAL_MS * 1000000L};
+    while (!atomic_load_explicit(&reporter.stop, memory_order_relaxed)) {
+        nanosleep(&interval, NULL);
+        const long long done = atomic_load_explicit(&progress_work, memory_order_relaxed);
+        int percent = reporter.total > 0 ? (int)(done * 100 / reporter.total) : 0;
+        if (percent > 99) percent = 99; // 100% is printed once the kernel returned
+        if (percent > shown) {
+            shown = percent;
+            print_progress_bar(percent);
+        }
+    }
+    return NULL;
+}
+#endif
+
+// starts the reporter for a kernel that will do total_work progress units
+void progress_begin(long long total_work) {
+    printf("\n");
+    print_progress_bar(0);
+#ifndef BENCH_NO_PROGRESS
+    atomic_store_explicit(&progress_work, 0, memory_order_relaxed);
+    progress_pending = 0;
+    reporter.total = total_work;
+    atomic_store_explicit(&reporter.stop, 0, memory_order_relaxed);
+    pthread_create(&reporter.thread, NULL, progress_reporter_thread, NULL);
+#else
+    (void)total_work;
+#endif
+}
+
+void progress_end(void) {
+#ifndef BENCH_NO_PROGRESS
+    atomic_store_explicit(&reporter.stop, 1, memory_order_relaxed);
+    pthread_join(reporter.thread, NULL);
+#endif
+    print_progress_bar(100);
+    printf("\n");
+}
+
+// runs warmups + repetitions of a sort kernel, each on a fresh copy of src. The copy and the
+// reporter start/stop stay outside the timed region. Returns -1 if the work buffer can not be allocated
+int time_sort_kernel(const int *src, int n, SortKernel kernel, long long progress_total, TimingStats *stats) {
+    kernel_threads_used = 1;
+    int *work = work_buffer_get(n);
+    double *samples = malloc(config.repetitions * sizeof(double));
+    if (work == NULL || samples == NULL) {
+        printf("Memory allocation failed\n");
+        work_buffer_put(work);
+        free(samples);
+        return -1;
+    }
+
+    double spent = 0.0;
+    int count = 0;
+    for (int r = 0; r < config.warmups + config.repetitions; r++) {
+        const int warmup = r < config.warmups;
+        // warmups are skipped once the budget is gone, and at least one timed run always happens
+        if (spent > config.time_budget && config.time_budget > 0 && (warmup || count > 0)) {
+            if (warmup) continue;
+            break;
+        }
+
+        memcpy(work, src, n * sizeof(int));
+        progress_begin(progress_total);
+        const uint64_t start = timer_now();
+        kernel(work, n);
+        const uint64_t end = timer_now();
+        progress_end();
+
+        const double elapsed = (double)(end - start) / 1e9;
+        spent += elapsed;
+        if (!warmup) samples[count++] = elapsed;
+    }
+
+    compute_stats(samples, count, n, stats);
+    free(samples);
+    work_buffer_put(work);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// search workloads: one lookup is far below the timer resolution, so every search algorithm runs
+// the same stream of queries drawn from the dataset (hits, misses, hot keys). A throughput pass
+// times whole chunks of queries, a latency pass times every query into a histogram. Warm mode
+// runs the stream once untimed first, cold mode flushes the caches before every chunk
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int *queries;
+    int count;
+    int hits;          // queries whose key is in the dataset
+    int n;             // dataset the stream was drawn from
+    uint64_t checksum;
+} SearchWorkload;
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} LatencyHistogram;
+
+static SearchWorkload search_workload;
+
+static inline double unit_random(uint64_t r) {
+    return (double)(r >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// a key strictly between two neighbours of the sorted keys, so it is absent but still lands in
+// the middle of the array like a real miss
+int search_miss_key(const int *sorted, int n, uint64_t seed, uint64_t i) {
+    for (uint64_t attempt = 0; attempt < 64; attempt++) {
+        const uint64_t r = generator_random(seed, i * 64 + attempt);
+        const int k = (int)(r % (uint64_t)n);
+        if (k + 1 < n) {
+            const long long gap = (long long)sorted[k + 1] - sorted[k];
+            if (gap > 1) return (int)(sorted[k] + 1 + (long long)((r >> 32) % (uint64_t)(gap - 1)));
+        }
+    }
+    if (sorted[0] > INT_MIN) return sorted[0] - 1;
+    return sorted[n - 1] < INT_MAX ? sorted[n - 1] + 1 : INT_MIN;
+}
+
+// zipf(s) over the ranks 1..n by rejection-inversion (Hörmann and Derflinger): constant time per
+// draw and no table over the ranks
+typedef struct {
+    double s;
+    double n;
+    double h_integral_x1;
+    double h_integral_n;
+    double shift;
+} ZipfSampler;
+
+// (exp(x) - 1) / x and log1p(x) / x, stable around 0
+static inline double zipf_expm1_ratio(double x) {
+    return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x / 2.0;
+}
+
+static inline double zipf_log1p_ratio(double x) {
+    return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x / 2.0;
+}
+
+static inline double zipf_h_integral(const ZipfSampler *z, double x) {
+    const double log_x = log(x);
+    return zipf_expm1_ratio((1.0 - z->s) * log_x) * log_x;
+}
+
+static inline double zipf_h_integral_inverse(const ZipfSampler *z, double x) {
+    double t = x * (1.0 - z->s);
+    if (t < -1.0) t = -1.0;
+    return exp(zipf_log1p_ratio(t) * x);
+}
+
+static inline double zipf_h(const ZipfSampler *z, double x) {
+    return exp(-z->s * log(x));
+}
+
+void zipf_init(ZipfSampler *z, double s, int n) {
+    z->s = s;
+    z->n = n;
+    z->h_integral_x1 = zipf_h_integral(z, 1.5) - 1.0;
+    z->h_integral_n = zipf_h_integral(z, n + 0.5);
+    z->shift = 2.0 - zipf_h_integral_inverse(z, zipf_h_integral(z, 2.5) - zipf_h(z, 2.0));
+}
+
+// rank in [1, n] for draw i, a pure function of (seed, i) like the rest of the workload
+int zipf_sample(const ZipfSampler *z, uint64_t seed, uint64_t i) {
+    for (uint64_t attempt = 0;; attempt++) {
+        const double u = z->h_integral_n +
+                         unit_random(generator_random(seed + attempt * 0x632be59bd9b4e019ULL, i)) * (z->h_integral_x1 - z->h_integral_n);
+        const double x = zipf_h_integral_inverse(z, u);
+        double k = floor(x + 0.5);
+        if (k < 1.0) k = 1.0;
+        else if (k > z->n) k = z->n;
+        if (k - x <= z->shift || u >= zipf_h_integral(z, k + 0.5) - zipf_h(z, k)) return (int)k;
+    }
+}
+
+typedef struct {
+    int *queries;
+    const int *sorted;
+    int n;
+    const int *hot;
+    uint64_t seed;
+    ZipfSampler zipf;
+    atomic_int hits;
+} WorkloadFill;
+
+// query q only depends on (seed, q), so the slices are filled in parallel
+void search_workload_fill(void *arg, int lo, int hi) {
+    WorkloadFill *fill = (WorkloadFill *)arg;
+    const uint64_t n = (uint64_t)fill->n;
+    int hits = 0;
+    for (int q = lo; q < hi; q++) {
+        if (unit_random(generator_random(fill->seed, q)) < config.hit_ratio) {
+            const uint64_t pick = generator_random(fill->seed ^ 2, q);
+            if (config.zipf > 0) {
+                // the rank-r key is a fixed random key of the dataset, so the hot keys are spread out
+                const int rank = zipf_sample(&fill->zipf, fill->seed ^ 4, (uint64_t)q);
+                fill->queries[q] = fill->sorted[generator_random(fill->seed ^ 5, (uint64_t)rank) % n];
+            } else if (unit_random(pick) < config.hot_ratio) {
+                fill->queries[q] = fill->hot[(pick >> 20) % (uint64_t)config.hot_keys];
+            } else {
+                fill->queries[q] = fill->sorted[(pick >> 20) % n];
+            }
+            hits++;
+        } else {
+            fill->queries[q] = search_miss_key(fill->sorted, fill->n, fill->seed ^ 3, (uint64_t)q);
+        }
+    }
+    atomic_fetch_add_explicit(&fill->hits, hits, memory_order_relaxed);
+}
+
+// everything the stream depends on, names the query file next to the dataset checksum
+uint64_t search_workload_key(int n) {
+    uint64_t bits[3];
+    memcpy(&bits[0], &config.hit_ratio, sizeof(double));
+    memcpy(&bits[1], &config.hot_ratio, sizeof(double));
+    memcpy(&bits[2], &config.zipf, sizeof(double));
+    uint64_t key = mix64((config.seed_set ? config.seed : 0) ^ ((uint64_t)n << 1) ^ QUERY_FORMAT_VERSION);
+    key = mix64(key ^ (uint64_t)config.search_queries);
+    key = mix64(key ^ ((uint64_t)config.hot_keys << 1 | (uint64_t)config.queries_sorted));
+    for (int i = 0; i < 3; i++) key = mix64(key ^ bits[i]);
+    return key;
+}
+
+void search_workload_path(uint64_t checksum, uint64_t key, char *out, size_t len) {
+    snprintf(out, len, "%s/queries_%016llx_%016llx%s", config.cache_dir, (unsigned long long)checksum,
+             (unsigned long long)key, DATASET_BINARY_EXT);
+}
+
+// query file: the dataset header with QUERY_MAGIC, checksum of the dataset, the hits and the
+// workload key in the reserved bytes, then the queries
+int search_workload_save(const SearchWorkload *wl, const char *path, uint64_t key) {
+    if (mkdir(config.cache_dir, 0755) != 0 && errno != EEXIST) return -1;
+    char tmp_path[MAX_PATH_LENGTH];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) return -1;
+
+    DatasetHeader header;
+    dataset_fill_header(&header, (uint64_t)wl->count, config.seed_set ? config.seed : 0, wl->checksum);
+    memcpy(header.magic, QUERY_MAGIC, sizeof(header.magic));
+    const uint64_t hits = (uint64_t)wl->hits;
+    memcpy(header.reserved, &hits, sizeof(hits));
+    memcpy(header.reserved + sizeof(hits), &key, sizeof(key));
+    const int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(wl->queries, sizeof(int), (size_t)wl->count, file) == (size_t)wl->count;
+    if (fclose(file) != 0 || !ok || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int search_workload_load(SearchWorkload *wl, const char *path, int n, uint64_t checksum, uint64_t key) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return -1;
+    DatasetHeader header;
+    uint64_t hits, stored_key;
+    int ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, QUERY_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == DATASET_VERSION && header.elem_size == sizeof(int) && header.checksum == checksum &&
+             header.count == (uint64_t)config.search_queries;
+    if (ok) {
+        memcpy(&hits, header.reserved, sizeof(hits));
+        memcpy(&stored_key, header.reserved + sizeof(hits), sizeof(stored_key));
+        ok = stored_key == key;
+    }
+    if (ok) {
+        wl->queries = malloc(header.count * sizeof(int));
+        ok = wl->queries != NULL && fseek(file, (long)header.payload_offset, SEEK_SET) == 0 &&
+             fread(wl->queries, sizeof(int), header.count, file) == header.count;
+    }
+    fclose(file);
+    if (!ok) {
+        free(wl->queries);
+        wl->queries = NULL;
+        return -1;
+    }
+    wl->count = (int)header.count;
+    wl->hits = (int)hits;
+    wl->n = n;
+    wl->checksum = checksum;
+    return 0;
+}
+
+// draws config.search_queries queries from arr with the configured mix: hit ratio, a uniform hot
+// set or zipf over all the keys, random or sorted order. With the cache on the stream is written
+// to a query file and read back by later runs with the same dataset and settings. The keys are
+// drawn from sorted keys: the sorted-array searches (and the skewed keys) pass them already, an
+// unsorted dataset uses the sorted snapshot the sorted-array searches share, so a miss sorts at
+// most once per dataset (and not at all when the snapshot is cached)
+int search_workload_build(SearchWorkload *wl, const int *arr, int n, uint64_t checksum) {
+    free(wl->queries);
+    memset(wl, 0, sizeof(*wl));
+    if (n <= 0) return -1;
+
+    char path[MAX_PATH_LENGTH];
+    const uint64_t key = search_workload_key(n);
+    if (config.cache_dir != NULL) {
+        search_workload_path(checksum, key, path, sizeof(path));
+        if (search_workload_load(wl, path, n, checksum, key) == 0) {
+            printf("Consultas leídas de %s\n", path);
+            return 0;
+        }
+    }
+
+    int ordered = 1;
+    for (int i = 1; i < n && ordered; i++) ordered = arr[i - 1] <= arr[i];
+    // the snapshot belongs to the dataset, a nested set with its own checksum (the skewed keys)
+    // is always sorted and never replaces it
+    const int *sorted = ordered ? arr : sorted_snapshot_get(arr, n);
+    if (sorted == NULL) return -1;
+    int *hot = malloc(config.hot_keys * sizeof(int));
+    wl->queries = malloc(config.search_queries * sizeof(int));
+    if (hot == NULL || wl->queries == NULL) {
+        printf("Memory allocation failed\n");
+        free(hot);
+        free(wl->queries);
+        wl->queries = NULL;
+        return -1;
+    }
+
+    // the same seed and dataset always give the same stream
+    const uint64_t seed = mix64((config.seed_set ? config.seed : 0) ^ checksum);
+    for (int h = 0; h < config.hot_keys; h++) hot[h] = sorted[generator_random(seed ^ 1, h) % (uint64_t)n];
+
+    WorkloadFill fill = {.queries = wl->queries, .sorted = sorted, .n = n, .hot = hot, .seed = seed};
+    atomic_init(&fill.hits, 0);
+    if (config.zipf > 0) zipf_init(&fill.zipf, config.zipf, n);
+    pool_parallel_for(0, config.search_queries, pool_threads(config.threads), search_workload_fill, &fill);
+    if (config.queries_sorted) qsort(wl->queries, config.search_queries, sizeof(int), compare_ints);
+
+    wl->hits = atomic_load(&fill.hits);
+    wl->count = config.search_queries;
+    wl->n = n;
+    wl->checksum = checksum;
+    free(hot);
+
+    if (config.cache_dir != NULL && search_workload_save(wl, path, key) == 0) printf("Consultas guardadas en %s\n", path);
+    return 0;
+}
+
+// the stream of the current dataset, all the algorithms of one dataset share it
+const SearchWorkload *search_workload_for(const int *arr, int n) {
+    if (search_workload.queries == NULL || search_workload.n != n ||
+        search_workload.checksum != result_context.checksum) {
+        if (search_workload_build(&search_workload, arr, n, result_context.checksum) != 0) return NULL;
+    }
+    return &search_workload;
+}
+
+int hist_index(uint64_t ns) {
+    if (ns < HIST_SUB) return (int)ns;
+    const int msb = 63 - __builtin_clzll(ns);
+    if (msb >= HIST_MAX_BITS) return HIST_BUCKETS - 1;
+    return HIST_SUB + (msb - HIST_SUB_BITS) * HIST_SUB + (int)((ns >> (msb - HIST_SUB_BITS)) - HIST_SUB);
+}
+
+// middle of the bucket, in ns
+double hist_value(int index) {
+    if (index < HIST_SUB) return index;
+    const int magnitude = (index - HIST_SUB) / HIST_SUB;
+    const int sub = (index - HIST_SUB) % HIST_SUB;
+    const double width = (double)(1ULL << magnitude);
+    return (HIST_SUB + sub) * width + width / 2.0;
+}
+
+void hist_record(LatencyHistogram *hist, uint64_t ns) {
+    hist->counts[hist_index(ns)]++;
+    if (hist->total == 0 || ns < hist->min) hist->min = ns;
+    if (ns > hist->max) hist->max = ns;
+    hist->total++;
+}
+
+double hist_percentile(const LatencyHistogram *hist, double q) {
+    if (hist->total == 0) return 0.0;
+    const uint64_t rank = (uint64_t)ceil(q * (double)hist->total);
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank && hist->counts[i] > 0) return hist_value(i);
+    }
+    return (double)hist->max;
+}
+
+// cost of a timer_now pair, subtracted from every latency
+uint64_t timer_overhead_ns(void) {
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < 1000; r++) {
+        const uint64_t start = timer_now();
+        const uint64_t end = timer_now();
+        if (end - start < best) best = end - start;
+    }
+    return best;
+}
+
+// streams over a buffer larger than the last level cache so the next chunk starts cold
+void search_flush_caches(void) {
+    static unsigned char *flush;
+    if (flush == NULL) {
+        flush = malloc(SEARCH_FLUSH_BYTES);
+        if (flush == NULL) return;
+        memset(flush, 1, SEARCH_FLUSH_BYTES);
+    }
+    for (size_t i = 0; i < SEARCH_FLUSH_BYTES; i += 64) flush[i]++;
+}
+
+// throughput pass then latency pass over the stream, each stops once the budget is spent.
+// stats gets the latency percentiles (seconds per query), *qps the throughput
+int time_search_workload(const int *arr, int n, SearchKernel kernel, const SearchWorkload *wl, TimingStats *stats,
+                         double *qps, LatencyHistogram *hist) {
+    const int chunk = config.search_cold ? SEARCH_COLD_CHUNK : SEARCH_CHUNK;
+    const double budget_ns = config.time_budget > 0 ? config.time_budget * 1e9 : INFINITY;
+    volatile long long sink;
+    long long found = 0;
+    kernel_threads_used = 1;
+
+    if (!config.search_cold) {
+        for (int r = 0; r < config.warmups; r++) {
+            const uint64_t start = timer_now();
+            for (int q = 0; q < wl->count; q++) {
+                found += kernel(arr, n, wl->queries[q]);
+                if (q % chunk == 0 && (double)(timer_now() - start) > budget_ns) break;
+            }
+        }
+    }
+
+    uint64_t spent = 0;
+    int done = 0;
+    for (int first = 0; first < wl->count && (double)spent <= budget_ns; first += chunk) {
+        const int last = first + chunk < wl->count ? first + chunk : wl->count;
+        if (config.search_cold) search_flush_caches();
+        const uint64_t start = timer_now();
+        for (int q = first; q < last; q++) found += kernel(arr, n, wl->queries[q]);
+        spent += timer_now() - start;
+        done = last;
+    }
+    *qps = spent > 0 ? done / ((double)spent / 1e9) : 0.0;
+
+    const uint64_t overhead = timer_overhead_ns();
+    memset(hist, 0, sizeof(*hist));
+    double sum = 0.0, sq = 0.0;
+    spent = 0;
+    for (int first = 0; first < wl->count && (double)spent <= budget_ns; first += chunk) {
+        const int last = first + chunk < wl->count ? first + chunk : wl->count;
+        if (config.search_cold) search_flush_caches();
+        for (int q = first; q < last; q++) {
+            const uint64_t start = timer_now();
+            found += kernel(arr, n, wl->queries[q]);
+            const uint64_t elapsed = timer_now() - start;
+            const uint64_t ns = elapsed > overhead ? elapsed - overhead : 0;
+            hist_record(hist, ns);
+            sum += (double)ns;
+            sq += (double)ns * (double)ns;
+            spent += elapsed;
+        }
+    }
+    // keeps the lookups from being optimized away
+    sink = found;
+    (void)sink;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->threads = kernel_threads_used;
+    stats->reps = (int)hist->total;
+    stats->min = hist->min / 1e9;
+    stats->median = hist_percentile(hist, 0.50) / 1e9;
+    stats->p90 = hist_percentile(hist, 0.90) / 1e9;
+    stats->p99 = hist_percentile(hist, 0.99) / 1e9;
+    stats->mean = *qps > 0 ? 1.0 / *qps : 0.0;
+    if (hist->total > 1) {
+        const double mean_ns = sum / hist->total;
+        stats->stddev = sqrt(fmax(0.0, (sq - hist->total * mean_ns * mean_ns) / (hist->total - 1))) / 1e9;
+    }
+    stats->ns_per_element = n > 0 ? stats->median * 1e9 / n : 0.0;
+    return 0;
+}
+
+// the whole measure_* flow for a sort: timing, results csv and report
+int benchmark_sort(const char *alg_name, const int *arr, int n, SortKernel kernel, long long progress_total) {
+    TimingStats stats;
+    if (time_sort_kernel(arr, n, kernel, progress_total, &stats) != 0) return -1;
+    write_result(alg_name, n, &stats);
+    print_stats(n, &stats);
+    return 0;
+}
+
+// runs the kernel once with every thread on a copy and compares it with qsort
+int verify_sort_kernel(const char *alg_name, const int *arr, int n, SortKernel kernel) {
+    int *result = work_buffer_get(n);
+    int *reference = work_buffer_get(n);
+    if (result == NULL || reference == NULL) {
+        printf("Memory allocation failed\n");
+        work_buffer_put(result);
+        work_buffer_put(reference);
+        return -1;
+    }
+    memcpy(result, arr, n * sizeof(int));
+    memcpy(reference, arr, n * sizeof(int));
+
+    kernel_threads = config.threads;
+    kernel(result, n);
+    kernel_threads = 1;
+    qsort(reference, n, sizeof(int), compare_ints);
+
+    int mismatch = -1;
+    for (int i = 0; i < n && mismatch < 0; i++) {
+        if (result[i] != reference[i]) mismatch = i;
+    }
+    work_buffer_put(result);
+    work_buffer_put(reference);
+
+    if (mismatch >= 0) {
+        printf("%s: resultado incorrecto en la posición %d (tamaño %d)\n", alg_name, mismatch, n);
+        return -1;
+    }
+    printf("%s: verificado contra qsort (tamaño %d)\n", alg_name, n);
+    return 0;
+}
+
+// one lookup of goal for the report, then the workload of the dataset for the numbers
+int benchmark_search(const char *alg_name, const char *label, const int *arr, int n, int goal, SearchKernel kernel) {
+    const int position = kernel(arr, n, goal);
+    printf("Algoritmo: %s\n", label);
+    printf("Elemento %d %s\n", goal, position >= 0 ? "encontrado" : "no encontrado");
+    if (position >= 0) printf("Posición: %d\n", position);
+
+    const SearchWorkload *wl = search_workload_for(arr, n);
+    if (wl == NULL) return -1;
+    TimingStats stats;
+    LatencyHistogram hist;
+    double qps;
+    if (time_search_workload(arr, n, kernel, wl, &stats, &qps, &hist) != 0) return -1;
+    write_search_result(alg_name, n, &stats);
+
+    printf("Consultas: %d (%.0f%% aciertos, caché %s) | %.0f consultas/s\n", wl->count, 100.0 * wl->hits / wl->count,
+           config.search_cold ? "fría" : "caliente", qps);
+    printf("Latencia (%llu consultas): p50 %.0f ns | p90 %.0f ns | p99 %.0f ns | p99.9 %.0f ns | máx %llu ns\n",
+           (unsigned long long)hist.total, hist_percentile(&hist, 0.50), hist_percentile(&hist, 0.90),
+           hist_percentile(&hist, 0.99), hist_percentile(&hist, 0.999), (unsigned long long)hist.max);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// input distributions: the catalogue the distribution x size matrix runs over. Every generator
+// is deterministic in (seed, n) and keeps the keys in the 8 digit range of the files; the
+// shaped ones start from the uniform keys and sort, reverse, swap or fold them. The killer is
+// built against quick_sort_recursive by replaying its partitions with the middle element
+// always the largest key left, so every partition peels off one element. The organ pipe puts
+// the maximum in the middle too and turns out nearly as bad for that pivot
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char *key;
+    const char *name;
+    int prefix_stable;      // a prefix is a smaller input of the same kind
+    int kills_middle_pivot; // quick_sort_recursive goes quadratic and n calls deep on it
+    void (*fill)(int *arr, int n, uint64_t seed);
+} Distribution;
+
+typedef struct {
+    int *arr;
+    uint64_t seed;
+    const ZipfSampler *zipf;
+} DistributionFill;
+
+void distribution_uniform_body(void *arg, int lo, int hi) {
+    const DistributionFill *fill = (const DistributionFill *)arg;
+    for (int i = lo; i < hi; i++) fill->arr[i] = generator_key(fill->seed, (uint64_t)i);
+}
+
+void distribution_few_unique_body(void *arg, int lo, int hi) {
+    const DistributionFill *fill = (const DistributionFill *)arg;
+    for (int i = lo; i < hi; i++) {
+        fill->arr[i] = generator_key(fill->seed ^ 1, generator_random(fill->seed, (uint64_t)i) % FEW_UNIQUE_KEYS);
+    }
+}
+
+// rank 1 is the most frequent key, every rank maps to its own uniform key
+void distribution_zipf_body(void *arg, int lo, int hi) {
+    const DistributionFill *fill = (const DistributionFill *)arg;
+    for (int i = lo; i < hi; i++) {
+        fill->arr[i] = generator_key(fill->seed ^ 1, (uint64_t)zipf_sample(fill->zipf, fill->seed, (uint64_t)i));
+    }
+}
+
+void distribution_parallel_fill(int *arr, int n, uint64_t seed, const ZipfSampler *zipf,
+                                void (*body)(void *arg, int lo, int hi)) {
+    DistributionFill fill = {arr, seed, zipf};
+    pool_parallel_for(0, n, pool_threads(config.threads), body, &fill);
+}
+
+void fill_uniform(int *arr, int n, uint64_t seed) {
+    distribution_parallel_fill(arr, n, seed, NULL, distribution_uniform_body);
+}
+
+void fill_sorted(int *arr, int n, uint64_t seed) {
+    fill_uniform(arr, n, seed);
+    parallel_radix_sort(arr, n, config.threads);
+}
+
+void fill_reversed(int *arr, int n, uint64_t seed) {
+    fill_sorted(arr, n, seed);
+    for (int i = 0, j = n - 1; i < j; i++, j--) {
+        const int temp = arr[i];
+        arr[i] = arr[j];
+        arr[j] = temp;
+    }
+}
+
+// sorted, then NEARLY_SORTED_SWAPS random pairs per 1000 elements exchanged
+void fill_nearly_sorted(int *arr, int n, uint64_t seed) {
+    fill_sorted(arr, n, seed);
+    const long long swaps = (long long)n * NEARLY_SORTED_SWAPS / 1000;
+    for (long long s = 0; s < swaps; s++) {
+        const int a = (int)(generator_random(seed ^ 1, (uint64_t)(2 * s)) % (uint64_t)n);
+        const int b = (int)(generator_random(seed ^ 1, (uint64_t)(2 * s + 1)) % (uint64_t)n);
+        const int temp = arr[a];
+        arr[a] = arr[b];
+        arr[b] = temp;
+    }
+}
+
+// rises to the largest key in the middle and falls back: the even ranks going up, the odd ones
+// coming down
+void fill_organ_pipe(int *arr, int n, uint64_t seed) {
+    int *sorted = work_buffer_get((size_t)n);
+    if (sorted == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    fill_sorted(sorted, n, seed);
+    for (int k = 0; 2 * k < n; k++) arr[k] = sorted[2 * k];
+    for (int k = 0; 2 * k + 1 < n; k++) arr[n - 1 - k] = sorted[2 * k + 1];
+    work_buffer_put(sorted);
+}
+
+void fill_few_unique(int *arr, int n, uint64_t seed) {
+    distribution_parallel_fill(arr, n, seed, NULL, distribution_few_unique_body);
+}
+
+void fill_zipf(int *arr, int n, uint64_t seed) {
+    ZipfSampler zipf;
+    zipf_init(&zipf, DISTRIBUTION_ZIPF_S, n > 0 ? n : 1);
+    distribution_parallel_fill(arr, n, seed, &zipf, distribution_zipf_body);
+}
+
+void fill_all_equal(int *arr, int n, uint64_t seed) {
+    const int key = generator_key(seed, 0);
+    for (int i = 0; i < n; i++) arr[i] = key;
+}
+
+// replays quick_sort_recursive on slot labels: the range is always [0, right], its middle gets
+// the largest rank left and is swapped to the end, which is exactly what the partition does
+// when the pivot is the maximum. Ranks map to evenly spaced distinct keys, the seed is unused
+void fill_quick_killer(int *arr, int n, uint64_t seed) {
+    (void)seed;
+    if (n <= 0) return;
+    int *labels = work_buffer_get((size_t)n);
+    if (labels == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) labels[i] = i;
+
+    const uint64_t step = n > 1 ? (GENERATOR_KEY_RANGE - 1) / (uint64_t)(n - 1) : 0;
+    int rank = n - 1;
+    for (int right = n - 1; right > 0; right--) {
+        const int mid = right / 2;
+        arr[labels[mid]] = GENERATOR_MIN_KEY + (int)((uint64_t)rank-- * step);
+        const int temp = labels[mid];
+        labels[mid] = labels[right];
+        labels[right] = temp;
+    }
+    arr[labels[0]] = GENERATOR_MIN_KEY;
+    work_buffer_put(labels);
+}
+
+static const Distribution distributions[] = {
+    {"uniform", "Uniforme", 1, 0, fill_uniform},
+    {"sorted", "Ordenado", 1, 0, fill_sorted},
+    {"reversed", "Invertido", 1, 0, fill_reversed},
+    {"nearly-sorted", "Casi ordenado", 1, 0, fill_nearly_sorted},
+    {"organ-pipe", "Órgano (sube y baja)", 0, 1, fill_organ_pipe},
+    {"few-unique", "Pocos valores distintos", 1, 0, fill_few_unique},
+    {"zipf", "Zipf", 1, 0, fill_zipf},
+    {"all-equal", "Todos iguales", 1, 0, fill_all_equal},
+    {"killer", "Anti-quicksort (pivote central)", 0, 1, fill_quick_killer},
+};
+#define NUM_DISTRIBUTIONS ((int)(sizeof(distributions) / sizeof(distributions[0])))
+
+const Distribution *distribution_find(const char *key) {
+    for (int d = 0; d < NUM_DISTRIBUTIONS; d++) {
+        if (strcmp(distributions[d].key, key) == 0) return &distributions[d];
+    }
+    return NULL;
+}
+
+// n keys of dist in a read-only anonymous mapping, released with dataset_close
+int distribution_generate(Dataset *ds, const Distribution *dist, int n, uint64_t seed) {
+    memset(ds, 0, sizeof(*ds));
+    size_t bytes;
+    int *map = map_anonymous((size_t)n * sizeof(int), &bytes);
+    if (map == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    dist->fill(map, n, seed);
+    mprotect(map, bytes, PROT_READ);
+
+    ds->data = map;
+    ds->n = n;
+    ds->seed = seed;
+    ds->checksum = dataset_checksum(map, (size_t)n);
+    ds->map = map;
+    ds->map_len = bytes;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// complexity fitting: a size too slow to run is extrapolated from a geometric series of prefixes
+// of the same input (or of the same distribution regenerated at each size, when a prefix would
+// not keep its shape). Two cost models are fitted by least squares in log space, a power law
+// t = a * n^b and t = c * n * log2(n)^k; the one with the smaller residual is used and the
+// prediction comes with a 95% interval
+// ---------------------------------------------------------------------------
+
+typedef long long (*WorkFn)(int n);
+
+typedef struct {
+    int log_model;   // 0: a * n^b, 1: c * n * log2(n)^k
+    double alpha;    // ln a or ln c
+    double beta;     // b or k
+    double beta_ci;  // half width of the 95% interval of beta
+    double r2;       // of ln t
+    double s;        // residual standard error
+    double x_mean;
+    double sxx;
+    int points;
+} ComplexityFit;
+
+// two-sided 95% quantile of student's t
+double student_t95(int dof) {
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (dof < 1) return INFINITY;
+    if (dof <= 30) return table[dof - 1];
+    return 1.96;
+}
+
+double fit_x(int log_model, double n) {
+    return log_model ? log(log2(n)) : log(n);
+}
+
+double fit_y(int log_model, double n, double t) {
+    return log_model ? log(t) - log(n) : log(t);
+}
+
+// least squares y = alpha + beta x over the points; sse is the same whether measured on y or on
+// ln t, so the two models compare directly
+void fit_model(int log_model, const double *sizes, const double *times, int m, ComplexityFit *fit) {
+    double x[FIT_MAX_POINTS], y[FIT_MAX_POINTS];
+    double x_mean = 0.0, y_mean = 0.0, lt_mean = 0.0;
+    for (int i = 0; i < m; i++) {
+        x[i] = fit_x(log_model, sizes[i]);
+        y[i] = fit_y(log_model, sizes[i], times[i]);
+        x_mean += x[i];
+        y_mean += y[i];
+        lt_mean += log(times[i]);
+    }
+    x_mean /= m;
+    y_mean /= m;
+    lt_mean /= m;
+
+    double sxx = 0.0, sxy = 0.0, sst = 0.0;
+    for (int i = 0; i < m; i++) {
+        sxx += (x[i] - x_mean) * (x[i] - x_mean);
+        sxy += (x[i] - x_mean) * (y[i] - y_mean);
+        sst += (log(times[i]) - lt_mean) * (log(times[i]) - lt_mean);
+    }
+    fit->log_model = log_model;
+    fit->beta = sxx > 0 ? sxy / sxx : 0.0;
+    fit->alpha = y_mean - fit->beta * x_mean;
+
+    double sse = 0.0;
+    for (int i = 0; i < m; i++) {
+        const double r = y[i] - (fit->alpha + fit->beta * x[i]);
+        sse += r * r;
+    }
+    fit->points = m;
+    fit->x_mean = x_mean;
+    fit->sxx = sxx;
+    fit->s = m > 2 ? sqrt(sse / (m - 2)) : 0.0;
+    fit->r2 = sst > 0 ? 1.0 - sse / sst : 1.0;
+    fit->beta_ci = sxx > 0 ? student_t95(m - 2) * fit->s / sqrt(sxx) : INFINITY;
+}
+
+// predicted time at n with its 95% prediction interval
+double fit_predict(const ComplexityFit *fit, double n, double *low, double *high) {
+    const double x0 = fit_x(fit->log_model, n);
+    const double y0 = fit->alpha + fit->beta * x0;
+    const double half = student_t95(fit->points - 2) * fit->s *
+                        sqrt(1.0 + 1.0 / fit->points + (x0 - fit->x_mean) * (x0 - fit->x_mean) / fit->sxx);
+    const double shift = fit->log_model ? log(n) : 0.0;
+    *low = exp(y0 - half + shift);
+    *high = exp(y0 + half + shift);
+    return exp(y0 + shift);
+}
+
+// measures the prefixes FIT_MIN_SIZE, FIT_RATIO * FIT_MIN_SIZE... up to max_size (or the first point over
+// FIT_POINT_BUDGET), fits both models and stores the extrapolation to n as an estimate
+int estimate_sort_by_fit(const char *alg_name, const int *arr, int n, int max_size, SortKernel kernel, WorkFn work) {
+    double sizes[FIT_MAX_POINTS], times[FIT_MAX_POINTS];
+    int m = 0;
+
+    // a prefix of an organ pipe or of the killer is not one, those are generated again per size
+    const Distribution *dist = distribution_find(result_context.distribution);
+    int *regenerated = NULL;
+    if (dist != NULL && !dist->prefix_stable) {
+        regenerated = malloc((size_t)(max_size < n ? max_size : n) * sizeof(int));
+        if (regenerated == NULL) {
+            printf("Memory allocation failed\n");
+            return -1;
+        }
+    }
+
+    printf("Tamaño %d demasiado lento para medirlo, se ajusta un modelo de costo:\n", n);
+    for (double next = FIT_MIN_SIZE; next <= max_size && next < n && m < FIT_MAX_POINTS; next *= FIT_RATIO) {
+        const int size = (int)(next + 0.5);
+        const int *input = arr;
+        if (regenerated != NULL) {
+            dist->fill(regenerated, size, result_context.seed);
+            input = regenerated;
+        }
+        TimingStats stats;
+        if (time_sort_kernel(input, size, kernel, work(size), &stats) != 0) {
+            free(regenerated);
+            return -1;
+        }
+        printf("  n = %d | mediana %.6f s\n", size, stats.median);
+        // below the timer resolution a point says nothing about the growth
+        if (stats.median > 0) {
+            sizes[m] = size;
+            times[m] = stats.median;
+            m++;
+        }
+        if (stats.median > FIT_POINT_BUDGET) break;
+    }
+    free(regenerated);
+    if (m < 3) {
+        printf("No hay suficientes tamaños medibles para estimar %s con %d elementos.\n", alg_name, n);
+        return -1;
+    }
+
+    ComplexityFit power, nlog;
+    fit_model(0, sizes, times, m, &power);
+    fit_model(1, sizes, times, m, &nlog);
+    const ComplexityFit *best = nlog.r2 > power.r2 ? &nlog : &power;
+
+    printf("  t = %.3e * n^%.3f (±%.3f) | R² = %.4f\n", exp(power.alpha), power.beta, power.beta_ci, power.r2);
+    printf("  t = %.3e * n * log2(n)^%.3f (±%.3f) | R² = %.4f\n", exp(nlog.alpha), nlog.beta, nlog.beta_ci, nlog.r2);
+
+    double low, high;
+    const double predicted = fit_predict(best, n, &low, &high);
+    TimingStats stats;
+    estimate_stats(predicted, low, high, n, &stats);
+    write_result(alg_name, n, &stats);
+    printf("Tamaño: %d | Tiempo ESTIMADO (%s, %d puntos): %.6f s | IC 95%%: [%.6f, %.6f] s\n", n,
+           best->log_model ? "n log^k n" : "potencia", m, predicted, low, high);
+    return 0;
+}
+
+void bubble_sort_kernel(int *arr, int n) {
+    // Bubble Sort, progress unit: one comparison
+    for (int i = 0; i < n-1; i++) {
+        PROGRESS_ADD(n-i-1);
+        // Algorithm itself
+        for (int j = 0; j < n-i-1; j++) {
+            if (arr[j] > arr[j+1]) {
+                int temp = arr[j];
+                arr[j] = arr[j+1];
+                arr[j+1] = temp;
+            }
+        }
+    }
+}
+
+long long bubble_work(int n) {
+    return (long long)n * (n - 1) / 2;
+}
+
+int measure_bubble_sort(int *arr, int n) {
+    const char *alg_name = "Bubble Sort";
+
+    // past BUBBLE_MAX_MEASURED (13 s at 100k) the time is extrapolated from smaller prefixes
+    if (n > BUBBLE_MAX_MEASURED) {
+        return estimate_sort_by_fit(alg_name, arr, n, BUBBLE_MAX_MEASURED, bubble_sort_kernel, bubble_work);
+    }
+
+    return benchmark_sort(alg_name, arr, n, bubble_sort_kernel, bubble_work(n));
+}
+
+// progress unit: one element in its final position
+void quick_sort_recursive(int *arr, int left, int right) {
+    if (left >= right) {
+        if (left == right) PROGRESS_ADD(1);
+        return;
+    }
+
+    int pivot = arr[(left + right) / 2];
+    int i = left, j = right;
+
+    while (i <= j) {
+        while (arr[i] < pivot) i++;
+        while (arr[j] > pivot) j--;
+        if (i <= j) {
+            int temp = arr[i];
+            arr[i] = arr[j];
+            arr[j] = temp;
+            i++;
+            j--;
+        }
+    }
+
+    // elements strictly between j and i are equal to the pivot and already placed
+    PROGRESS_ADD(i - j - 1);
+
+    quick_sort_recursive(arr, left, j);
+    quick_sort_recursive(arr, i, right);
+}
+
+void quick_sort_kernel(int *arr, int n) {
+    quick_sort_recursive(arr, 0, n-1);
+}
+
+long long quick_work(int n) {
+    return n;
+}
+
+int measure_quick_sort(int *arr, int n) {
+    // on the killer and the organ pipe the middle pivot goes quadratic and about n calls deep, past
+    // QUICK_ADVERSARIAL_MAX_MEASURED it is extrapolated like bubble sort instead of overflowing the stack
+    const Distribution *dist = distribution_find(result_context.distribution);
+    if (dist != NULL && dist->kills_middle_pivot && n > QUICK_ADVERSARIAL_MAX_MEASURED) {
+        return estimate_sort_by_fit("Quick Sort", arr, n, QUICK_ADVERSARIAL_MAX_MEASURED, quick_sort_kernel, quick_work);
+    }
+    return benchmark_sort("Quick Sort", arr, n, quick_sort_kernel, n);
+}
+
+void heap_sift_down(int *arr, int root, int n) {
+    const int value = arr[root];
+    int child;
+    while ((child = 2 * root + 1) < n) {
+        if (child + 1 < n && arr[child + 1] > arr[child]) child++;
+        if (arr[child] <= value) break;
+        arr[root] = arr[child];
+        root = child;
+    }
+    arr[root] = value;
+}
+
+void heap_sort(int *arr, int n) {
+    for (int i = n / 2 - 1; i >= 0; i--) heap_sift_down(arr, i, n);
+    for (int end = n - 1; end > 0; end--) {
+        const int temp = arr[0];
+        arr[0] = arr[end];
+        arr[end] = temp;
+        heap_sift_down(arr, 0, end);
+    }
+}
+
+static inline int median_of_three(int a, int b, int c) {
+    if (a < b) {
+        if (b < c) return b;
+        return a < c ? c : a;
+    }
+    if (a < c) return a;
+    return b < c ? c : b;
+}
+
+// median of 3 for small ranges, Tukey's ninther (median of three medians) for large ones
+int choose_pivot(const int *arr, int lo, int hi) {
+    const int n = hi - lo;
+    const int mid = lo + n / 2;
+    if (n <= INTROSORT_NINTHER_MIN) return median_of_three(arr[lo], arr[mid], arr[hi - 1]);
+
+    const int step = n / 8;
+    const int m1 = median_of_three(arr[lo], arr[lo + step], arr[lo + 2 * step]);
+    const int m2 = median_of_three(arr[mid - step], arr[mid], arr[mid + step]);
+    const int m3 = median_of_three(arr[hi - 1 - 2 * step], arr[hi - 1 - step], arr[hi - 1]);
+    return median_of_three(m1, m2, m3);
+}
+
+// sorts [lo, hi): same partition scheme as quick_sort_recursive, but it only recurses into the
+// smaller side (stack depth stays O(log n)), insertion sorts small ranges and switches to heap sort
+// once depth_limit partitions went by, so bad inputs can not go quadratic
+// progress unit: one element in its final position
+void introsort_loop(int *arr, int lo, int hi, int depth_limit) {
+    while (hi - lo > INTROSORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            heap_sort(arr + lo, hi - lo);
+            PROGRESS_ADD(hi - lo);
+            return;
+        }
+        depth_limit--;
+
+        const int pivot = choose_pivot(arr, lo, hi);
+        int i = lo, j = hi - 1;
+        while (i <= j) {
+            while (arr[i] < pivot) i++;
+            while (arr[j] > pivot) j--;
+            if (i <= j) {
+                int temp = arr[i];
+                arr[i] = arr[j];
+                arr[j] = temp;
+                i++;
+                j--;
+            }
+        }
+        PROGRESS_ADD(i - j - 1);
+
+        // now [lo, j] <= pivot <= [i, hi)
+        if (j + 1 - lo < hi - i) {
+            introsort_loop(arr, lo, j + 1, depth_limit);
+            lo = i;
+        } else {
+            introsort_loop(arr, i, hi, depth_limit);
+            hi = j + 1;
+        }
+    }
+    insertion_sort(arr + lo, hi - lo);
+    PROGRESS_ADD(hi - lo);
+}
+
+void introsort(int *arr, int n) {
+    int depth_limit = 0;
+    for (int len = n; len > 1; len >>= 1) depth_limit += 2;
+    introsort_loop(arr, 0, n, depth_limit);
+}
+
+void introsort_kernel(int *arr, int n) {
+    introsort(arr, n);
+}
+
+int measure_introsort(int *arr, int n) {
+    return benchmark_sort("Introsort", arr, n, introsort_kernel, n);
+}
+
+// progress unit: one call on a range of at most 2 elements
+void stooge_sort_recursive(int *arr, int l, int h) {
+    if (l >= h) {
+        PROGRESS_ADD(1);
+        return;
+    }
+
+    // If first element is smaller than last, swap them
+    if (arr[l] > arr[h]) {
+        int temp = arr[l];
+        arr[l] = arr[h];
+        arr[h] = temp;
+    }
+
+    // If there are more than 2 elements in the array
+    if (h - l + 1 > 2) {
+        int t = (h - l + 1) / 3;
+
+        // Recursively sort first 2/3 elements
+        stooge_sort_recursive(arr, l, h - t);
+
+        // Recursively sort last 2/3 elements
+        stooge_sort_recursive(arr, l + t, h);
+
+        // Recursively sort first 2/3 elements again
+        stooge_sort_recursive(arr, l, h - t);
+    } else {
+        PROGRESS_ADD(1);
+    }
+}
+
+// number of ranges of at most 2 elements the recursion visits, the three calls all get len - len/3
+long long stooge_leaves(long long len) {
+    if (len <= 2) return 1;
+    return 3 * stooge_leaves(len - len / 3);
+}
+
+void stooge_sort_kernel(int *arr, int n) {
+    stooge_sort_recursive(arr, 0, n-1);
+}
+
+long long stooge_work(int n) {
+    return stooge_leaves(n);
+}
+
+int measure_stooge_sort(int *arr, int n) {
+    const char *alg_name = "Stooge Sort";
+
+    // O(n^2.71): minutes at 10k, so anything larger is extrapolated from smaller prefixes
+    if (n > STOOGE_MAX_MEASURED) {
+        return estimate_sort_by_fit(alg_name, arr, n, STOOGE_MAX_MEASURED, stooge_sort_kernel, stooge_work);
+    }
+
+    return benchmark_sort(alg_name, arr, n, stooge_sort_kernel, stooge_work(n));
+}
+
+int get_min(int a, int b) {
+    if (a < b){
+        return a;
+    }
+    return b;
+}
+
+// LSD radix sort on the bytes of the keys. All the histograms come out of a single read pass,
+// every pass scatters from src into dst and then they swap roles, and a pass is skipped when all
+// the keys share that byte. Signed order comes from flipping the sign bit of every key.
+// progress unit: one element per pass (skipped passes count too)
+void radix_sort_with_buffer(int *arr, int *buffer, int n) {
+    uint32_t hist[RADIX_PASSES][RADIX_BUCKETS];
+    memset(hist, 0, sizeof(hist));
+
+    for (int i = 0; i < n; i++) {
+        const uint32_t key = (uint32_t)arr[i] ^ RADIX_SIGN_FLIP;
+        hist[0][key & RADIX_MASK]++;
+        hist[1][(key >> 8) & RADIX_MASK]++;
+        hist[2][(key >> 16) & RADIX_MASK]++;
+        hist[3][key >> 24]++;
+    }
+
+    int *src = arr;
+    int *dst = buffer;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        const int shift = pass * RADIX_BITS;
+        uint32_t *count = hist[pass];
+
+        if (n == 0 || count[(((uint32_t)src[0] ^ RADIX_SIGN_FLIP) >> shift) & RADIX_MASK] == (uint32_t)n) {
+            PROGRESS_ADD(n);
+            continue;
+        }
+
+        // exclusive prefix sum turns the counts into the first slot of every bucket
+        uint32_t offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            const uint32_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        for (int i = 0; i < n; i++) {
+            const uint32_t digit = (((uint32_t)src[i] ^ RADIX_SIGN_FLIP) >> shift) & RADIX_MASK;
+            dst[count[digit]++] = src[i];
+        }
+
+        int *temp = src;
+        src = dst;
+        dst = temp;
+        PROGRESS_ADD(n);
+    }
+
+    // an odd number of real passes leaves the result in the buffer
+    if (src != arr) memcpy(arr, src, n * sizeof(int));
+}
+
+void radix_sort_kernel(int *arr, int n) {
+    int *buffer = work_buffer_get(n);
+    if (buffer == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    radix_sort_with_buffer(arr, buffer, n);
+    work_buffer_put(buffer);
+}
+
+int measure_radix_sort(int *arr, int n) {
+    return benchmark_sort("Radix Sort", arr, n, radix_sort_kernel, (long long)RADIX_PASSES * n);
+}
+
+// barrier for the phases of the parallel kernels (pthread_barrier_t is missing on macOS)
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int count;
+    int waiting;
+    unsigned long generation;
+} SimpleBarrier;
+
+void barrier_init(SimpleBarrier *barrier, int count) {
+    pthread_mutex_init(&barrier->mutex, NULL);
+    pthread_cond_init(&barrier->cond, NULL);
+    barrier->count = count;
+    barrier->waiting = 0;
+    barrier->generation = 0;
+}
+
+void barrier_destroy(SimpleBarrier *barrier) {
+    pthread_mutex_destroy(&barrier->mutex);
+    pthread_cond_destroy(&barrier->cond);
+}
+
+void barrier_wait(SimpleBarrier *barrier) {
+    pthread_mutex_lock(&barrier->mutex);
+    const unsigned long generation = barrier->generation;
+    if (++barrier->waiting == barrier->count) {
+        barrier->waiting = 0;
+        barrier->generation++;
+        pthread_cond_broadcast(&barrier->cond);
+    } else {
+        while (generation == barrier->generation) pthread_cond_wait(&barrier->cond, &barrier->mutex);
+    }
+    pthread_mutex_unlock(&barrier->mutex);
+}
+
+// state shared by the threads of one parallel radix sort
+typedef struct {
+    int *arr;
+    int *buffer;
+    int *wc; // RADIX_BUCKETS lines of write-combining buffer per thread
+    int n;
+    uint32_t (*hist)[RADIX_BUCKETS]; // one histogram per thread for the current pass
+    SimpleBarrier barrier;
+} ParallelRadixShared;
+
+// every thread owns the slice [lo, hi) of src in every pass: it histograms it, computes where its
+// elements of each bucket go (after the same bucket of the threads before it) and scatters them
+// through 64 byte write-combining buffers. An element waits in its bucket's buffer at the
+// position it will have inside its destination cache line, and the line is written once the
+// buffer reaches the line end, so apart from the first and last line of every bucket each store
+// to dst is a whole aligned cache line
+void parallel_radix_task(void *arg, int id, int num_threads) {
+    ParallelRadixShared *shared = (ParallelRadixShared *)arg;
+    const int T = num_threads;
+    const int n = shared->n;
+    const int chunk = n / T;
+    const int lo = id * chunk;
+    const int hi = (id == T - 1) ? n : lo + chunk;
+
+    int (*wc)[RADIX_WC_ELEMS] = (int (*)[RADIX_WC_ELEMS])(shared->wc + (size_t)id * RADIX_BUCKETS * RADIX_WC_ELEMS);
+    int wc_start[RADIX_BUCKETS], wc_end[RADIX_BUCKETS];
+    uint32_t offset[RADIX_BUCKETS];
+
+    int *src = shared->arr;
+    int *dst = shared->buffer;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        const int shift = pass * RADIX_BITS;
+        uint32_t *hist = shared->hist[id];
+
+        memset(hist, 0, RADIX_BUCKETS * sizeof(uint32_t));
+        for (int i = lo; i < hi; i++) {
+            hist[(((uint32_t)src[i] ^ RADIX_SIGN_FLIP) >> shift) & RADIX_MASK]++;
+        }
+        barrier_wait(&shared->barrier);
+
+        // every thread derives the same totals, so the skip decision needs no extra sync
+        uint32_t base = 0;
+        int skip = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            uint32_t total = 0, before = 0;
+            for (int t = 0; t < T; t++) {
+                if (t == id) before = total;
+                total += shared->hist[t][b];
+            }
+            if (total == (uint32_t)n) skip = 1;
+            offset[b] = base + before;
+            base += total;
+        }
+
+        if (!skip) {
+            // position of every bucket's first element inside its cache line of dst
+            for (int b = 0; b < RADIX_BUCKETS; b++) {
+                wc_start[b] = wc_end[b] = (int)(((uintptr_t)(dst + offset[b]) / sizeof(int)) & (RADIX_WC_ELEMS - 1));
+            }
+            for (int i = lo; i < hi; i++) {
+                const int value = src[i];
+                const uint32_t digit = (((uint32_t)value ^ RADIX_SIGN_FLIP) >> shift) & RADIX_MASK;
+                wc[digit][wc_end[digit]++] = value;
+                if (wc_end[digit] == RADIX_WC_ELEMS) {
+                    const int count = RADIX_WC_ELEMS - wc_start[digit];
+                    memcpy(&dst[offset[digit]], &wc[digit][wc_start[digit]], count * sizeof(int));
+                    offset[digit] += count;
+                    wc_start[digit] = wc_end[digit] = 0;
+                }
+            }
+            for (int b = 0; b < RADIX_BUCKETS; b++) {
+                memcpy(&dst[offset[b]], &wc[b][wc_start[b]], (wc_end[b] - wc_start[b]) * sizeof(int));
+            }
+            int *temp = src;
+            src = dst;
+            dst = temp;
+        }
+        PROGRESS_ADD(hi - lo);
+        // nobody may histogram the next pass (or reuse hist) before all the scatters are done
+        barrier_wait(&shared->barrier);
+    }
+
+    if (src != shared->arr) memcpy(&shared->arr[lo], &src[lo], (hi - lo) * sizeof(int));
+    return;
+}
+
+void parallel_radix_sort(int *arr, int n, int num_threads) {
+    num_threads = pool_threads(num_threads);
+    if (num_threads > n / RADIX_MIN_PER_THREAD) num_threads = n / RADIX_MIN_PER_THREAD;
+    if (num_threads < 1) num_threads = 1;
+    kernel_threads_used = num_threads;
+
+    ParallelRadixShared shared;
+    shared.arr = arr;
+    shared.n = n;
+    shared.buffer = work_buffer_get(n);
+    // pooled like the buffer, so no repetition pays for allocating it; the pool hands out page
+    // aligned memory, every thread's lines start on a cache line
+    shared.wc = work_buffer_get((size_t)num_threads * RADIX_BUCKETS * RADIX_WC_ELEMS);
+    shared.hist = malloc(num_threads * sizeof(*shared.hist));
+    if (shared.buffer == NULL || shared.wc == NULL || shared.hist == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    barrier_init(&shared.barrier, num_threads);
+
+    pool_run(num_threads, parallel_radix_task, &shared);
+
+    barrier_destroy(&shared.barrier);
+    free(shared.hist);
+    work_buffer_put(shared.wc);
+    work_buffer_put(shared.buffer);
+}
+
+void parallel_radix_sort_kernel(int *arr, int n) {
+    parallel_radix_sort(arr, n, kernel_threads);
+}
+
+// what a kernel wants printed under its sweep row, set during the last run
+static char sweep_note[MAX_NAME_LENGTH * 2];
+
+// sweeps 1, 2, 4... up to --threads and stores one result per thread count, so the csv holds
+// the speedup curve of a parallel kernel. Rows are named by the threads the kernel really used;
+// once its size cap stops it from using more, the sweep ends
+int benchmark_parallel_sort(const char *base_name, const int *arr, int n, SortKernel kernel, long long progress_total) {
+    double base_time = 0.0;
+    int status = 0;
+
+    int threads = 1, last_used = 0;
+    while (1) {
+        kernel_threads = threads;
+        sweep_note[0] = '\0';
+        TimingStats stats;
+        if (time_sort_kernel(arr, n, kernel, progress_total, &stats) != 0) {
+            status = -1;
+            break;
+        }
+        if (stats.threads == last_used) {
+            printf("Hilos: %d pedidos, el algoritmo usa %d con %d elementos; no se miden más puntos\n", threads,
+                   stats.threads, n);
+            break;
+        }
+        last_used = stats.threads;
+
+        char alg_name[MAX_NAME_LENGTH];
+        snprintf(alg_name, sizeof(alg_name), "%s (%dt)", base_name, stats.threads);
+        write_result(alg_name, n, &stats);
+        if (threads == 1) base_time = stats.median;
+        printf("Hilos: %d | ", stats.threads);
+        print_stats(n, &stats);
+        if (stats.median > 0) printf("Aceleración frente a 1 hilo: %.2fx\n", base_time / stats.median);
+        if (sweep_note[0] != '\0') printf("%s\n", sweep_note);
+
+        if (threads >= config.threads) break;
+        threads = threads * 2 < config.threads ? threads * 2 : config.threads;
+    }
+
+    kernel_threads = 1;
+    return status;
+}
+
+int measure_parallel_radix_sort(int *arr, int n) {
+    return benchmark_parallel_sort("Parallel Radix Sort", arr, n, parallel_radix_sort_kernel, (long long)RADIX_PASSES * n);
+}
+
+// ---------------------------------------------------------------------------
+// typed kernels: the same LSD radix sort and lower bound generated for other element types by
+// the DEFINE_* templates below, each instance with its key width fixed at compile time. A type
+// only supplies an unsigned key that orders like the element: the sign bit flipped for signed
+// integers, for doubles the bit pattern with negatives fully inverted. Records carry a row id
+// (and a payload) behind the key, and argsort sorts (key, index) pairs to get a permutation.
+// typed_radix_sort and typed_lower_bound pick the instance with _Generic
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int32_t key;
+    uint32_t row;
+} Record8;
+
+typedef struct {
+    int64_t key;
+    uint64_t row;
+} Record16;
+
+typedef struct {
+    int64_t key;
+    uint64_t row;
+    uint64_t payload[2];
+} Record32;
+
+_Static_assert(sizeof(Record8) == 8 && sizeof(Record16) == 16 && sizeof(Record32) == 32, "record sizes");
+
+typedef void (*TypedSortFn)(void *arr, void *buffer, int n);
+typedef int (*TypedCheckFn)(const void *arr, int n);
+
+static inline uint32_t sortable_i32(int32_t x) {
+    return (uint32_t)x ^ RADIX_SIGN_FLIP;
+}
+
+static inline uint64_t sortable_i64(int64_t x) {
+    return (uint64_t)x ^ RADIX_SIGN_FLIP64;
+}
+
+// ieee doubles order like sign-magnitude integers: negatives get every bit flipped, positives
+// only the sign. -0.0 sorts before 0.0 and NaNs go to the ends
+static inline uint64_t sortable_f64(double x) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits ^ ((uint64_t)((int64_t)bits >> 63) | RADIX_SIGN_FLIP64);
+}
+
+#define KEY_I32(x) sortable_i32(x)
+#define KEY_I64(x) sortable_i64(x)
+#define KEY_F64(x) sortable_f64(x)
+#define KEY_REC8(r) sortable_i32((r).key)
+#define KEY_REC16(r) sortable_i64((r).key)
+
+// LSD radix sort on KEY(element), one read for the histograms of every pass, passes where all
+// the elements share the digit are skipped. NAME_any is the type-erased entry for the tables
+#define DEFINE_RADIX_SORT(NAME, TYPE, KEY_TYPE, KEY)                                                     \
+    void NAME(TYPE *arr, TYPE *buffer, int n) {                                                          \
+        enum { PASSES = (int)sizeof(KEY_TYPE) * 8 / RADIX_BITS };                                        \
+        uint32_t hist[PASSES][RADIX_BUCKETS];                                                            \
+        memset(hist, 0, sizeof(hist));                                                                   \
+        for (int i = 0; i < n; i++) {                                                                    \
+            const KEY_TYPE key = KEY(arr[i]);                                                            \
+            for (int pass = 0; pass < PASSES; pass++) hist[pass][(key >> (pass * RADIX_BITS)) & RADIX_MASK]++; \
+        }                                                                                                \
+        TYPE *src = arr;                                                                                 \
+        TYPE *dst = buffer;                                                                              \
+        for (int pass = 0; pass < PASSES; pass++) {                                                      \
+            const int shift = pass * RADIX_BITS;                                                         \
+            uint32_t *count = hist[pass];                                                                \
+            if (n == 0 || count[(KEY(src[0]) >> shift) & RADIX_MASK] == (uint32_t)n) continue;           \
+            uint32_t offset = 0;                                                                         \
+            for (int b = 0; b < RADIX_BUCKETS; b++) {                                                    \
+                const uint32_t c = count[b];                                                             \
+                count[b] = offset;                                                                       \
+                offset += c;                                                                             \
+            }                                                                                            \
+            for (int i = 0; i < n; i++) dst[count[(KEY(src[i]) >> shift) & RADIX_MASK]++] = src[i];      \
+            TYPE *temp = src;                                                                            \
+            src = dst;                                                                                   \
+            dst = temp;                                                                                  \
+        }                                                                                                \
+        if (src != arr) memcpy(arr, src, (size_t)n * sizeof(TYPE));                                      \
+    }                                                                                                    \
+    void NAME##_any(void *arr, void *buffer, int n) {                                                    \
+        NAME((TYPE *)arr, (TYPE *)buffer, n);                                                            \
+    }
+
+// first index whose key is >= goal, branchless like branchless_search. goal is a plain key of
+// GOAL_TYPE (the element key type), GOAL_KEY turns it into the sortable key
+#define DEFINE_LOWER_BOUND(NAME, TYPE, KEY_TYPE, KEY, GOAL_TYPE, GOAL_KEY)                               \
+    int NAME(const TYPE *arr, int n, GOAL_TYPE goal) {                                                   \
+        if (n <= 0) return 0;                                                                            \
+        const KEY_TYPE key = GOAL_KEY(goal);                                                             \
+        const TYPE *base = arr;                                                                          \
+        int len = n;                                                                                     \
+        while (len > 1) {                                                                                \
+            const int half = len / 2;                                                                    \
+            base += (KEY(base[half - 1]) < key) * half;                                                  \
+            len -= half;                                                                                 \
+        }                                                                                                \
+        return (int)(base - arr) + (KEY(*base) < key);                                                   \
+    }
+
+// 1 when the keys never decrease
+#define DEFINE_IS_SORTED(NAME, TYPE, KEY)                                                                \
+    int NAME(const void *data, int n) {                                                                  \
+        const TYPE *arr = (const TYPE *)data;                                                            \
+        for (int i = 1; i < n; i++) {                                                                    \
+            if (KEY(arr[i - 1]) > KEY(arr[i])) return 0;                                                 \
+        }                                                                                                \
+        return 1;                                                                                        \
+    }
+
+DEFINE_RADIX_SORT(radix_sort_i32, int32_t, uint32_t, KEY_I32)
+DEFINE_RADIX_SORT(radix_sort_i64, int64_t, uint64_t, KEY_I64)
+DEFINE_RADIX_SORT(radix_sort_f64, double, uint64_t, KEY_F64)
+DEFINE_RADIX_SORT(radix_sort_rec8, Record8, uint32_t, KEY_REC8)
+DEFINE_RADIX_SORT(radix_sort_rec16, Record16, uint64_t, KEY_REC16)
+DEFINE_RADIX_SORT(radix_sort_rec32, Record32, uint64_t, KEY_REC16)
+
+DEFINE_LOWER_BOUND(lower_bound_i32, int32_t, uint32_t, KEY_I32, int32_t, KEY_I32)
+DEFINE_LOWER_BOUND(lower_bound_i64, int64_t, uint64_t, KEY_I64, int64_t, KEY_I64)
+DEFINE_LOWER_BOUND(lower_bound_f64, double, uint64_t, KEY_F64, double, KEY_F64)
+DEFINE_LOWER_BOUND(lower_bound_rec8, Record8, uint32_t, KEY_REC8, int32_t, KEY_I32)
+DEFINE_LOWER_BOUND(lower_bound_rec16, Record16, uint64_t, KEY_REC16, int64_t, KEY_I64)
+DEFINE_LOWER_BOUND(lower_bound_rec32, Record32, uint64_t, KEY_REC16, int64_t, KEY_I64)
+
+DEFINE_IS_SORTED(is_sorted_i32, int32_t, KEY_I32)
+DEFINE_IS_SORTED(is_sorted_i64, int64_t, KEY_I64)
+DEFINE_IS_SORTED(is_sorted_f64, double, KEY_F64)
+DEFINE_IS_SORTED(is_sorted_rec8, Record8, KEY_REC8)
+DEFINE_IS_SORTED(is_sorted_rec16, Record16, KEY_REC16)
+DEFINE_IS_SORTED(is_sorted_rec32, Record32, KEY_REC16)
+
+#define typed_radix_sort(arr, buffer, n)                                                                 \
+    _Generic((arr), int32_t *: radix_sort_i32, int64_t *: radix_sort_i64, double *: radix_sort_f64,      \
+             Record8 *: radix_sort_rec8, Record16 *: radix_sort_rec16, Record32 *: radix_sort_rec32)(arr, buffer, n)
+
+// arr may be const or not; the goal converts to the key type of the array's instance (an int
+// goal against int64 or record keys becomes an int64), then sortable like the sort converts it
+#define typed_lower_bound(arr, n, goal)                                                                  \
+    _Generic((arr), int32_t *: lower_bound_i32, const int32_t *: lower_bound_i32,                       \
+             int64_t *: lower_bound_i64, const int64_t *: lower_bound_i64, double *: lower_bound_f64,    \
+             const double *: lower_bound_f64, Record8 *: lower_bound_rec8, const Record8 *: lower_bound_rec8, \
+             Record16 *: lower_bound_rec16, const Record16 *: lower_bound_rec16,                        \
+             Record32 *: lower_bound_rec32, const Record32 *: lower_bound_rec32)(arr, n, goal)
+
+// the dataset keys as the typed benchmarks store them, both keep the order of the int keys
+static inline int64_t typed_key_i64(int x) {
+    return ((int64_t)x - TYPED_KEY_CENTER) * TYPED_KEY_SCALE;
+}
+
+static inline double typed_key_f64(int x) {
+    return (double)((int64_t)x - TYPED_KEY_CENTER) / 1000.0;
+}
+
+// perm gets the stable sorting permutation of keys: keys[perm[0]] <= keys[perm[1]] <= ...
+// pairs and buffer hold n records each
+void argsort_i32(const int32_t *keys, int n, int32_t *perm, Record8 *pairs, Record8 *buffer) {
+    for (int i = 0; i < n; i++) {
+        pairs[i].key = keys[i];
+        pairs[i].row = (uint32_t)i;
+    }
+    typed_radix_sort(pairs, buffer, n);
+    for (int i = 0; i < n; i++) perm[i] = (int32_t)pairs[i].row;
+}
+
+// the argsort benchmark keeps its keys here, the sort signature only carries the output
+static const int32_t *argsort_keys;
+
+// arr is the permutation (n ints), buffer room for the two pair arrays
+void argsort_i32_any(void *arr, void *buffer, int n) {
+    Record8 *pairs = (Record8 *)buffer;
+    argsort_i32(argsort_keys, n, (int32_t *)arr, pairs, pairs + n);
+}
+
+int argsort_check(const void *data, int n) {
+    const int32_t *perm = (const int32_t *)data;
+    unsigned char *seen = calloc(n > 0 ? n : 1, 1);
+    int ok = seen != NULL;
+    for (int i = 0; i < n && ok; i++) {
+        ok = perm[i] >= 0 && perm[i] < n && !seen[perm[i]];
+        if (ok) seen[perm[i]] = 1;
+        // equal keys keep their input order
+        if (ok && i > 0) {
+            const int32_t a = argsort_keys[perm[i - 1]], b = argsort_keys[perm[i]];
+            ok = a < b || (a == b && perm[i - 1] < perm[i]);
+        }
+    }
+    free(seen);
+    return ok;
+}
+
+typedef struct {
+    const char *name;
+    size_t elem_size;
+    const void *src;
+    size_t buffer_elems; // scratch elements of elem_size
+    TypedSortFn sort;
+    TypedCheckFn check;
+} TypedSortCase;
+
+// time_sort_kernel for any element type: src is copied into a pooled work buffer before every run
+int time_typed_sort(const TypedSortCase *tc, int n, TimingStats *stats) {
+    void *work = work_buffer_get(((size_t)n * tc->elem_size + sizeof(int) - 1) / sizeof(int));
+    void *buffer = work_buffer_get((tc->buffer_elems * tc->elem_size + sizeof(int) - 1) / sizeof(int));
+    double *samples = malloc(config.repetitions * sizeof(double));
+    kernel_threads_used = 1;
+    if (work == NULL || buffer == NULL || samples == NULL) {
+        printf("Memory allocation failed\n");
+        work_buffer_put(work);
+        work_buffer_put(buffer);
+        free(samples);
+        return -1;
+    }
+
+    double spent = 0.0;
+    int count = 0, status = 0;
+    for (int r = 0; r < config.warmups + config.repetitions; r++) {
+        const int warmup = r < config.warmups;
+        if (spent > config.time_budget && config.time_budget > 0 && (warmup || count > 0)) {
+            if (warmup) continue;
+            break;
+        }
+
+        memcpy(work, tc->src, (size_t)n * tc->elem_size);
+        const uint64_t start = timer_now();
+        tc->sort(work, buffer, n);
+        const uint64_t end = timer_now();
+
+        if (r == 0 && !tc->check(work, n)) {
+            printf("%s: resultado incorrecto (tamaño %d)\n", tc->name, n);
+            status = -1;
+            break;
+        }
+        const double elapsed = (double)(end - start) / 1e9;
+        spent += elapsed;
+        if (!warmup) samples[count++] = elapsed;
+    }
+
+    compute_stats(samples, count, n, stats);
+    free(samples);
+    work_buffer_put(buffer);
+    work_buffer_put(work);
+    return status;
+}
+
+// the dataset as int64 keys, doubles and records of 8, 16 and 32 bytes, every one radix sorted,
+// plus an argsort, so the cost of wider keys and of moving payloads shows next to int32 keys
+int measure_typed_sorts(int *arr, int n) {
+    int64_t *keys64 = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    double *doubles = malloc((n > 0 ? n : 1) * sizeof(double));
+    Record8 *rec8 = malloc((n > 0 ? n : 1) * sizeof(Record8));
+    Record16 *rec16 = malloc((n > 0 ? n : 1) * sizeof(Record16));
+    Record32 *rec32 = malloc((n > 0 ? n : 1) * sizeof(Record32));
+    int status = 0;
+    if (keys64 == NULL || doubles == NULL || rec8 == NULL || rec16 == NULL || rec32 == NULL) {
+        printf("Memory allocation failed\n");
+        status = -1;
+    }
+
+    // centred so both signs show up, the int64 keys are spread over the upper bytes too
+    for (int i = 0; i < n && status == 0; i++) {
+        keys64[i] = typed_key_i64(arr[i]);
+        doubles[i] = typed_key_f64(arr[i]);
+        rec8[i] = (Record8){arr[i], (uint32_t)i};
+        rec16[i] = (Record16){keys64[i], (uint64_t)i};
+        rec32[i] = (Record32){keys64[i], (uint64_t)i, {(uint64_t)i * 2, (uint64_t)i * 3}};
+    }
+    argsort_keys = arr;
+
+    const TypedSortCase cases[] = {
+        {"Typed Radix Sort (int32 keys)", sizeof(int32_t), arr, (size_t)n, radix_sort_i32_any, is_sorted_i32},
+        {"Typed Radix Sort (int64 keys)", sizeof(int64_t), keys64, (size_t)n, radix_sort_i64_any, is_sorted_i64},
+        {"Typed Radix Sort (double keys)", sizeof(double), doubles, (size_t)n, radix_sort_f64_any, is_sorted_f64},
+        {"Typed Radix Sort (8-byte records)", sizeof(Record8), rec8, (size_t)n, radix_sort_rec8_any, is_sorted_rec8},
+        {"Typed Radix Sort (16-byte records)", sizeof(Record16), rec16, (size_t)n, radix_sort_rec16_any, is_sorted_rec16},
+        {"Typed Radix Sort (32-byte records)", sizeof(Record32), rec32, (size_t)n, radix_sort_rec32_any, is_sorted_rec32},
+        // the permutation is written over the copied keys, the pairs live in the scratch buffer
+        {"Argsort (int32 keys)", sizeof(int32_t), arr, (size_t)n * 2 * sizeof(Record8) / sizeof(int32_t), argsort_i32_any, argsort_check},
+    };
+
+    double key_only = 0.0;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]) && status == 0; c++) {
+        TimingStats stats;
+        if (time_typed_sort(&cases[c], n, &stats) != 0) {
+            status = -1;
+            break;
+        }
+        write_result(cases[c].name, n, &stats);
+        if (c == 0) key_only = stats.median;
+        printf("%s | %zu bytes por elemento\n", cases[c].name, cases[c].elem_size);
+        print_stats(n, &stats);
+        if (n > 0 && stats.median > 0) {
+            printf("%.1f M elem/s | %.2fx el tiempo de las claves int32\n", n / stats.median / 1e6,
+                   key_only > 0 ? stats.median / key_only : 0.0);
+        }
+    }
+
+    free(keys64);
+    free(doubles);
+    free(rec8);
+    free(rec16);
+    free(rec32);
+    return status;
+}
+
+// plain insertion sort, the small-range cutoff of the merge sorts
+void insertion_sort(int *arr, int n) {
+    for (int i = 1; i < n; i++) {
+        const int value = arr[i];
+        int j = i - 1;
+        while (j >= 0 && arr[j] > value) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = value;
+    }
+}
+
+// merge from mergesort, famous. Merges the sorted runs L and R into out (which overlaps neither),
+// taking from L on ties so the sort stays stable
+// progress unit: one element written by a merge
+void merge(const int *L, int n1, const int *R, int n2, int *out) {
+    int i = 0, j = 0, k = 0;
+    while (i < n1 && j < n2) {
+        const int take_left = L[i] <= R[j];
+        out[k++] = take_left ? L[i] : R[j];
+        i += take_left;
+        j += !take_left;
+    }
+
+    // copy the leftover elements of whichever run is not empty
+    memcpy(&out[k], &L[i], (n1 - i) * sizeof(int));
+    k += n1 - i;
+    memcpy(&out[k], &R[j], (n2 - j) * sizeof(int));
+    PROGRESS_ADD(n1 + n2);
+}
+
+// "divide-and-conquer" mergesort routine without allocations: arr and scratch enter with the same
+// contents, each half is sorted into scratch (using arr as its scratch) and then merged back into
+// arr, so the buffers swap roles at every level and nothing is copied
+void merge_sort_recursive(int *arr, int *scratch, int n) {
+    if (n <= MERGE_SORT_CUTOFF) {
+        insertion_sort(arr, n);
+        PROGRESS_ADD(n);
+        return;
+    }
+
+    const int middle = n / 2;
+    merge_sort_recursive(scratch, arr, middle);
+    merge_sort_recursive(scratch + middle, arr + middle, n - middle);
+    merge(scratch, middle, scratch + middle, n - middle, arr);
+}
+
+// sorts arr with a caller provided scratch buffer of n elements
+void merge_sort_with_buffer(int *arr, int *scratch, int n) {
+    memcpy(scratch, arr, n * sizeof(int));
+    merge_sort_recursive(arr, scratch, n);
+}
+
+void merge_sort_kernel(int *arr, int n) {
+    int *scratch = work_buffer_get(n);
+    if (scratch == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    // Call the recursive merge sort, this like a parent function, kinda broke ma head
+    merge_sort_with_buffer(arr, scratch, n);
+    work_buffer_put(scratch);
+}
+
+// every level above the cutoff merges the whole range once, plus the insertion sorted leaves
+long long merge_sort_work(int n) {
+    long long levels = 1;
+    for (long long len = n; len > MERGE_SORT_CUTOFF; len = (len + 1) / 2) levels++;
+    return levels * n;
+}
+
+int measure_merge_sort(int *arr, int n) {
+    return benchmark_sort("Merge Sort", arr, n, merge_sort_kernel, merge_sort_work(n));
+}
+
+// state shared by the threads of one parallel merge sort
+typedef struct {
+    int *arr;
+    int *buffer;
+    int n;
+    SimpleBarrier barrier;
+} ParallelMergeShared;
+
+// merge path: how many of the first d outputs of merging A and B come from A (ties go to A)
+int merge_path_split(const int *A, int na, const int *B, int nb, int d) {
+    int lo = d > nb ? d - nb : 0;
+    int hi = d < na ? d : na;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (A[mid] <= B[d - mid - 1]) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// phase 1 sorts one slice per thread, then every round merges pairs of neighbouring runs from src
+// into dst. The output of a round is cut into equal slices, one per thread, and merge path finds
+// where each slice starts inside its pair, so even the last merge of two halves uses every thread
+void parallel_merge_task(void *arg, int id, int num_threads) {
+    ParallelMergeShared *shared = (ParallelMergeShared *)arg;
+    const int T = num_threads;
+    const int n = shared->n;
+
+    int bounds[MAX_THREADS + 1];
+    for (int t = 0; t <= T; t++) bounds[t] = (int)((long long)n * t / T);
+    int runs = T;
+
+    merge_sort_with_buffer(shared->arr + bounds[id], shared->buffer + bounds[id], bounds[id + 1] - bounds[id]);
+    barrier_wait(&shared->barrier);
+
+    const int out_lo = bounds[id];
+    const int out_hi = bounds[id + 1];
+    int *src = shared->arr;
+    int *dst = shared->buffer;
+    while (runs > 1) {
+        for (int p = 0; p < runs; p += 2) {
+            const int start = bounds[p];
+            const int middle = bounds[p + 1];
+            const int end = (p + 2 <= runs) ? bounds[p + 2] : middle;
+            if (end <= out_lo || start >= out_hi) continue;
+
+            const int *A = src + start;
+            const int *B = src + middle;
+            const int na = middle - start;
+            const int nb = end - middle;
+            const int d0 = (out_lo > start ? out_lo : start) - start;
+            const int d1 = (out_hi < end ? out_hi : end) - start;
+            const int i0 = merge_path_split(A, na, B, nb, d0);
+            const int i1 = merge_path_split(A, na, B, nb, d1);
+            merge(A + i0, i1 - i0, B + (d0 - i0), (d1 - i1) - (d0 - i0), dst + start + d0);
+        }
+
+        // every thread keeps its own copy of the run boundaries, the pairs become the new runs
+        int merged = 0;
+        for (int p = 0; p < runs; p += 2) bounds[merged++] = bounds[p];
+        bounds[merged] = n;
+        runs = merged;
+
+        int *temp = src;
+        src = dst;
+        dst = temp;
+        barrier_wait(&shared->barrier);
+    }
+
+    if (src != shared->arr) memcpy(shared->arr + out_lo, src + out_lo, (out_hi - out_lo) * sizeof(int));
+}
+
+void parallel_merge_sort(int *arr, int n, int num_threads) {
+    num_threads = pool_threads(num_threads);
+    if (num_threads > n / MERGE_MIN_PER_THREAD) num_threads = n / MERGE_MIN_PER_THREAD;
+    if (num_threads < 1) num_threads = 1;
+    kernel_threads_used = num_threads;
+
+    ParallelMergeShared shared;
+    shared.arr = arr;
+    shared.n = n;
+    shared.buffer = work_buffer_get(n);
+    if (shared.buffer == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    barrier_init(&shared.barrier, num_threads);
+
+    pool_run(num_threads, parallel_merge_task, &shared);
+
+    barrier_destroy(&shared.barrier);
+    work_buffer_put(shared.buffer);
+}
+
+void parallel_merge_sort_kernel(int *arr, int n) {
+    parallel_merge_sort(arr, n, kernel_threads);
+}
+
+int measure_parallel_merge_sort(int *arr, int n) {
+    return benchmark_parallel_sort("Parallel Merge Sort", arr, n, parallel_merge_sort_kernel, merge_sort_work(n));
+}
+
+// ---------------------------------------------------------------------------
+// parallel quicksort: the first levels are partitioned by all the threads together (the serial
+// bottleneck of a plain parallel quicksort), then the ranges become tasks on per-worker deques.
+// A worker pops its own newest task, steals the oldest one of another worker when it runs dry, and
+// finishes ranges below the grain size with the sequential introsort
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int lo;
+    int hi;
+    int depth;
+} QuickTask;
+
+// owner pushes and pops at the bottom, thieves take from the top
+typedef struct {
+    pthread_mutex_t lock;
+    QuickTask tasks[PQUICK_DEQUE_CAPACITY];
+    int top;
+    int bottom;
+} WorkDeque;
+
+typedef struct {
+    int *arr;
+    int *tmp;
+    int n;
+    WorkDeque *deques;
+    atomic_int pending; // tasks pushed and not finished yet
+    SimpleBarrier barrier;
+
+    // parallel partition phase, written by thread 0 between barriers
+    QuickTask ranges[PQUICK_MAX_RANGES];
+    int num_ranges;
+    int partition_min; // smallest range worth partitioning with every thread
+    int partitions;    // ranges partitioned that way, for the report
+    int pivot;
+    int (*counts)[3]; // per thread: < pivot, == pivot, > pivot
+} ParallelQuickShared;
+
+int deque_push(WorkDeque *deque, QuickTask task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom == PQUICK_DEQUE_CAPACITY) {
+        // compact before giving up, stolen slots at the top are free again
+        const int used = deque->bottom - deque->top;
+        if (deque->top == 0) {
+            pthread_mutex_unlock(&deque->lock);
+            return 0;
+        }
+        memmove(deque->tasks, deque->tasks + deque->top, used * sizeof(QuickTask));
+        deque->top = 0;
+        deque->bottom = used;
+    }
+    deque->tasks[deque->bottom++] = task;
+    pthread_mutex_unlock(&deque->lock);
+    return 1;
+}
+
+int deque_pop(WorkDeque *deque, QuickTask *task) {
+    pthread_mutex_lock(&deque->lock);
+    const int found = deque->bottom > deque->top;
+    if (found) *task = deque->tasks[--deque->bottom];
+    if (deque->bottom == deque->top) deque->top = deque->bottom = 0;
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+int deque_steal(WorkDeque *deque, QuickTask *task) {
+    pthread_mutex_lock(&deque->lock);
+    const int found = deque->bottom > deque->top;
+    if (found) *task = deque->tasks[deque->top++];
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// partitions a task like introsort_loop does, pushing one side and keeping the other, until what
+// is left fits the grain and is sorted sequentially
+void pquick_run_task(ParallelQuickShared *shared, WorkDeque *own, QuickTask task) {
+    int *arr = shared->arr;
+    int lo = task.lo, hi = task.hi, depth = task.depth;
+
+    while (hi - lo > PQUICK_GRAIN && depth > 0) {
+        depth--;
+        const int pivot = choose_pivot(arr, lo, hi);
+        int i = lo, j = hi - 1;
+        while (i <= j) {
+            while (arr[i] < pivot) i++;
+            while (arr[j] > pivot) j--;
+            if (i <= j) {
+                int temp = arr[i];
+                arr[i] = arr[j];
+                arr[j] = temp;
+                i++;
+                j--;
+            }
+        }
+        PROGRESS_ADD(i - j - 1);
+
+        // the larger side is offered to the thieves, the smaller one stays hot in this cache
+        QuickTask larger = {i, hi, depth};
+        if (j + 1 - lo > hi - i) {
+            larger.lo = lo;
+            larger.hi = j + 1;
+            lo = i;
+        } else {
+            hi = j + 1;
+        }
+        atomic_fetch_add_explicit(&shared->pending, 1, memory_order_relaxed);
+        if (!deque_push(own, larger)) {
+            atomic_fetch_sub_explicit(&shared->pending, 1, memory_order_relaxed);
+            introsort_loop(arr, larger.lo, larger.hi, larger.depth);
+        }
+    }
+    introsort_loop(arr, lo, hi, depth);
+}
+
+void parallel_quick_task(void *arg, int id, int num_threads) {
+    ParallelQuickShared *shared = (ParallelQuickShared *)arg;
+    const int T = num_threads;
+
+    // phase 1: breadth-first, every range bigger than the grain is three-way partitioned by all the
+    // threads at once through the tmp buffer, until there are enough ranges to keep everyone busy
+    while (1) {
+        barrier_wait(&shared->barrier);
+        int target = -1;
+        for (int r = 0; r < shared->num_ranges; r++) {
+            if (shared->ranges[r].hi - shared->ranges[r].lo > shared->partition_min) {
+                target = r;
+                break;
+            }
+        }
+        if (target < 0 || shared->num_ranges >= T || shared->num_ranges + 1 >= PQUICK_MAX_RANGES) break;
+
+        const QuickTask range = shared->ranges[target];
+        const int len = range.hi - range.lo;
+        const int b_lo = range.lo + (int)((long long)len * id / T);
+        const int b_hi = range.lo + (int)((long long)len * (id + 1) / T);
+        if (id == 0) shared->pivot = choose_pivot(shared->arr, range.lo, range.hi);
+        barrier_wait(&shared->barrier);
+
+        const int pivot = shared->pivot;
+        int lt = 0, eq = 0;
+        for (int i = b_lo; i < b_hi; i++) {
+            lt += shared->arr[i] < pivot;
+            eq += shared->arr[i] == pivot;
+        }
+        shared->counts[id][0] = lt;
+        shared->counts[id][1] = eq;
+        shared->counts[id][2] = (b_hi - b_lo) - lt - eq;
+        barrier_wait(&shared->barrier);
+
+        int total_lt = 0, total_eq = 0, before_lt = 0, before_eq = 0, before_gt = 0;
+        for (int t = 0; t < T; t++) {
+            if (t == id) {
+                before_lt = total_lt;
+                before_eq = total_eq;
+            }
+            total_lt += shared->counts[t][0];
+            total_eq += shared->counts[t][1];
+            if (t < id) before_gt += shared->counts[t][2];
+        }
+        int pos_lt = range.lo + before_lt;
+        int pos_eq = range.lo + total_lt + before_eq;
+        int pos_gt = range.lo + total_lt + total_eq + before_gt;
+        for (int i = b_lo; i < b_hi; i++) {
+            const int value = shared->arr[i];
+            if (value < pivot) shared->tmp[pos_lt++] = value;
+            else if (value == pivot) shared->tmp[pos_eq++] = value;
+            else shared->tmp[pos_gt++] = value;
+        }
+        barrier_wait(&shared->barrier);
+
+        memcpy(shared->arr + b_lo, shared->tmp + b_lo, (b_hi - b_lo) * sizeof(int));
+        if (id == 0) {
+            // the elements equal to the pivot are final, the two sides replace the range
+            QuickTask less = {range.lo, range.lo + total_lt, range.depth - 1};
+            QuickTask greater = {range.lo + total_lt + total_eq, range.hi, range.depth - 1};
+            shared->ranges[target] = less;
+            shared->ranges[shared->num_ranges++] = greater;
+            shared->partitions++;
+            // every range is pushed as one task in phase 2
+            atomic_store_explicit(&shared->pending, shared->num_ranges, memory_order_relaxed);
+            PROGRESS_ADD(total_eq);
+        }
+    }
+
+    // phase 2: deal the ranges out round-robin and run the work-stealing loop
+    WorkDeque *own = &shared->deques[id];
+    for (int r = id; r < shared->num_ranges; r += T) {
+        deque_push(own, shared->ranges[r]);
+    }
+
+    unsigned int victim_seed = (unsigned int)id * 2654435761u + 1;
+    QuickTask task;
+    while (1) {
+        int found = deque_pop(own, &task);
+        for (int attempt = 0; !found && attempt < 2 * T; attempt++) {
+            victim_seed = victim_seed * 1103515245u + 12345u;
+            const int victim = (int)((victim_seed >> 16) % (unsigned int)T);
+            if (victim != id) found = deque_steal(&shared->deques[victim], &task);
+        }
+        if (found) {
+            pquick_run_task(shared, own, task);
+            atomic_fetch_sub_explicit(&shared->pending, 1, memory_order_acq_rel);
+        } else if (atomic_load_explicit(&shared->pending, memory_order_acquire) == 0) {
+            break;
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+void parallel_quick_sort(int *arr, int n, int num_threads) {
+    num_threads = pool_threads(num_threads);
+    if (num_threads > n / PQUICK_GRAIN) num_threads = n / PQUICK_GRAIN;
+    if (num_threads < 1) num_threads = 1;
+    kernel_threads_used = num_threads;
+    if (num_threads == 1) {
+        // one thread is the sequential introsort, so the sweep reports speedup against it
+        introsort(arr, n);
+        return;
+    }
+
+    int depth_limit = 0;
+    for (int len = n; len > 1; len >>= 1) depth_limit += 2;
+
+    ParallelQuickShared *shared = malloc(sizeof(ParallelQuickShared));
+    if (shared == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    shared->arr = arr;
+    shared->n = n;
+    shared->tmp = work_buffer_get(n);
+    shared->deques = malloc(num_threads * sizeof(WorkDeque));
+    shared->counts = malloc(num_threads * sizeof(*shared->counts));
+    if (shared->tmp == NULL || shared->deques == NULL || shared->counts == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (int t = 0; t < num_threads; t++) {
+        pthread_mutex_init(&shared->deques[t].lock, NULL);
+        shared->deques[t].top = shared->deques[t].bottom = 0;
+    }
+    shared->ranges[0].lo = 0;
+    shared->ranges[0].hi = n;
+    shared->ranges[0].depth = depth_limit;
+    shared->num_ranges = 1;
+    shared->partition_min = num_threads * PQUICK_PARTITION_GRAINS * PQUICK_GRAIN;
+    shared->partitions = 0;
+    atomic_store(&shared->pending, 1);
+    barrier_init(&shared->barrier, num_threads);
+
+    pool_run(num_threads, parallel_quick_task, shared);
+    snprintf(sweep_note, sizeof(sweep_note), "%d particiones con todos los hilos (rangos de más de %d elementos)",
+             shared->partitions, shared->partition_min);
+
+    for (int t = 0; t < num_threads; t++) pthread_mutex_destroy(&shared->deques[t].lock);
+    barrier_destroy(&shared->barrier);
+    free(shared->counts);
+    free(shared->deques);
+    work_buffer_put(shared->tmp);
+    free(shared);
+}
+
+void parallel_quick_sort_kernel(int *arr, int n) {
+    parallel_quick_sort(arr, n, kernel_threads);
+}
+
+int measure_parallel_quick_sort(int *arr, int n) {
+    return benchmark_parallel_sort("Parallel Quick Sort", arr, n, parallel_quick_sort_kernel, n);
+}
+
+// ---------------------------------------------------------------------------
+// bitonic sort: iterative network over the next power of two, padded with INT_MAX sentinels.
+// Stages whose pairs stay inside a BITONIC_BLOCK run block by block without barriers (the block
+// sits in L1), the wider stages are split across all threads with a barrier between them. The
+// compare-exchange of a run of pairs is vectorized: AVX2 picked at runtime, SSE2 or NEON otherwise
+// ---------------------------------------------------------------------------
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAVE_AVX2_DISPATCH 1
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+typedef void (*CompareExchangeFn)(int *a, int *b, int len, int ascending);
+
+// a[i], b[i] = min, max (or max, min when descending) for i < len
+void bitonic_cmpx_scalar(int *a, int *b, int len, int ascending) {
+    for (int i = 0; i < len; i++) {
+        const int x = a[i], y = b[i];
+        const int lo = x < y ? x : y;
+        const int hi = x < y ? y : x;
+        a[i] = ascending ? lo : hi;
+        b[i] = ascending ? hi : lo;
+    }
+}
+
+#if defined(__SSE2__)
+// sse2 has no 32-bit min/max, so the lanes are selected through the compare mask
+void bitonic_cmpx_sse2(int *a, int *b, int len, int ascending) {
+    int i = 0;
+    for (; i + 4 <= len; i += 4) {
+        const __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        const __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        const __m128i gt = _mm_cmpgt_epi32(x, y);
+        const __m128i lo = _mm_or_si128(_mm_and_si128(gt, y), _mm_andnot_si128(gt, x));
+        const __m128i hi = _mm_xor_si128(_mm_xor_si128(x, y), lo);
+        _mm_storeu_si128((__m128i *)(a + i), ascending ? lo : hi);
+        _mm_storeu_si128((__m128i *)(b + i), ascending ? hi : lo);
+    }
+    bitonic_cmpx_scalar(a + i, b + i, len - i, ascending);
+}
+#endif
+
+#ifdef HAVE_AVX2_DISPATCH
+__attribute__((target("avx2")))
+void bitonic_cmpx_avx2(int *a, int *b, int len, int ascending) {
+    int i = 0;
+    for (; i + 8 <= len; i += 8) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        const __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        const __m256i lo = _mm256_min_epi32(x, y);
+        const __m256i hi = _mm256_max_epi32(x, y);
+        _mm256_storeu_si256((__m256i *)(a + i), ascending ? lo : hi);
+        _mm256_storeu_si256((__m256i *)(b + i), ascending ? hi : lo);
+    }
+    bitonic_cmpx_sse2(a + i, b + i, len - i, ascending);
+}
+#endif
+
+#if defined(__ARM_NEON)
+void bitonic_cmpx_neon(int *a, int *b, int len, int ascending) {
+    int i = 0;
+    for (; i + 4 <= len; i += 4) {
+        const int32x4_t x = vld1q_s32(a + i);
+        const int32x4_t y = vld1q_s32(b + i);
+        const int32x4_t lo = vminq_s32(x, y);
+        const int32x4_t hi = vmaxq_s32(x, y);
+        vst1q_s32(a + i, ascending ? lo : hi);
+        vst1q_s32(b + i, ascending ? hi : lo);
+    }
+    bitonic_cmpx_scalar(a + i, b + i, len - i, ascending);
+}
+#endif
+
+// widest compare-exchange this cpu runs
+CompareExchangeFn bitonic_select_cmpx(void) {
+#ifdef HAVE_AVX2_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return bitonic_cmpx_avx2;
+#endif
+#if defined(__SSE2__)
+    return bitonic_cmpx_sse2;
+#elif defined(__ARM_NEON)
+    return bitonic_cmpx_neon;
+#else
+    return bitonic_cmpx_scalar;
+#endif
+}
+
+typedef struct {
+    int *buf;
+    int m; // power of two >= n
+    CompareExchangeFn cmpx;
+    SimpleBarrier barrier;
+} BitonicShared;
+
+// stage (k, j) compares i with i + j inside blocks of 2j elements, ascending when bit k of i is 0.
+// Pairs are numbered p = block * j + offset, so [p_begin, p_end) can be any slice of the stage,
+// progress unit: one compare-exchange
+void bitonic_stage(const BitonicShared *shared, int k, int j, int p_begin, int p_end) {
+    int p = p_begin;
+    while (p < p_end) {
+        const int block = p / j;
+        const int offset = p % j;
+        const int run = j - offset < p_end - p ? j - offset : p_end - p;
+        const int start = block * 2 * j;
+        int *a = shared->buf + start + offset;
+        shared->cmpx(a, a + j, run, (start & k) == 0);
+        p += run;
+    }
+    PROGRESS_ADD(p_end - p_begin);
+}
+
+// every stage of step k with 2j <= BITONIC_BLOCK, on the block at start
+void bitonic_block_stages(const BitonicShared *shared, int start, int block, int k) {
+    for (int j = (k < block ? k : block) / 2; j > 0; j /= 2) {
+        bitonic_stage(shared, k, j, start / 2, (start + block) / 2);
+    }
+}
+
+void bitonic_sort_task(void *arg, int id, int num_threads) {
+    BitonicShared *shared = (BitonicShared *)arg;
+    const int T = num_threads, m = shared->m;
+    const int block = m < BITONIC_BLOCK ? m : BITONIC_BLOCK;
+    const int blocks = m / block;
+    const int b_lo = (int)((long long)blocks * id / T);
+    const int b_hi = (int)((long long)blocks * (id + 1) / T);
+
+    // steps up to the block size never leave the block
+    for (int b = b_lo; b < b_hi; b++) {
+        for (int k = 2; k <= block; k *= 2) bitonic_block_stages(shared, b * block, block, k);
+    }
+
+    const int pairs = m / 2;
+    const int p_lo = (int)((long long)pairs * id / T);
+    const int p_hi = (int)((long long)pairs * (id + 1) / T);
+    for (int k = 2 * block; k <= m; k *= 2) {
+        for (int j = k / 2; 2 * j > block; j /= 2) {
+            barrier_wait(&shared->barrier);
+            bitonic_stage(shared, k, j, p_lo, p_hi);
+        }
+        barrier_wait(&shared->barrier);
+        for (int b = b_lo; b < b_hi; b++) bitonic_block_stages(shared, b * block, block, k);
+    }
+}
+
+void bitonic_sort(int *arr, int n, int num_threads) {
+    num_threads = pool_threads(num_threads);
+    if (n < 2) return;
+    int m = 1;
+    while (m < n) m *= 2;
+
+    BitonicShared shared;
+    shared.m = m;
+    shared.cmpx = bitonic_select_cmpx();
+    shared.buf = arr;
+    if (m != n) {
+        shared.buf = work_buffer_get(m);
+        if (shared.buf == NULL) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+        memcpy(shared.buf, arr, n * sizeof(int));
+        for (int i = n; i < m; i++) shared.buf[i] = INT_MAX;
+    }
+
+    // a thread needs at least one block for the barrier-free stages
+    const int blocks = m < BITONIC_BLOCK ? 1 : m / BITONIC_BLOCK;
+    if (num_threads > blocks) num_threads = blocks;
+    if (num_threads < 1) num_threads = 1;
+    kernel_threads_used = num_threads;
+    barrier_init(&shared.barrier, num_threads);
+
+    pool_run(num_threads, bitonic_sort_task, &shared);
+    barrier_destroy(&shared.barrier);
+
+    // the sentinels sort to the tail
+    if (shared.buf != arr) {
+        memcpy(arr, shared.buf, n * sizeof(int));
+        work_buffer_put(shared.buf);
+    }
+}
+
+void bitonic_sort_kernel(int *arr, int n) {
+    bitonic_sort(arr, n, kernel_threads);
+}
+
+// compare-exchanges of the padded network: m/2 per stage, log m (log m + 1) / 2 stages
+long long bitonic_work(int n) {
+    long long m = 1;
+    int log_m = 0;
+    while (m < n) {
+        m *= 2;
+        log_m++;
+    }
+    return m / 2 * log_m * (log_m + 1) / 2;
+}
+
+int measure_bitonic_sort(int *arr, int n) {
+    const char *alg_name = "Bitonic Sort";
+
+    if (verify_sort_kernel(alg_name, arr, n, bitonic_sort_kernel) != 0) return -1;
+    return benchmark_parallel_sort(alg_name, arr, n, bitonic_sort_kernel, bitonic_work(n));
+}
+
+// ---------------------------------------------------------------------------
+// sorted snapshots: the searches that need sorted keys share one sorted copy of the current
+// dataset. It is content addressed by the dataset checksum, cache/sorted_<checksum>_<n>.bin in
+// the binary dataset format, so a later run maps it read-only instead of sorting again and a
+// changed dataset simply gets a new file. Inside a session the copy stays in memory until
+// another dataset asks for one
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    Dataset ds;               // the mapped cache file, or the heap copy when it came from a sort
+    uint64_t source_checksum; // checksum of the unsorted dataset
+    int valid;
+} SortedSnapshot;
+
+static SortedSnapshot sorted_snapshot;
+
+void sorted_snapshot_path(uint64_t checksum, int n, char *out, size_t len) {
+    snprintf(out, len, "%s/sorted_%016llx_%d%s", config.cache_dir, (unsigned long long)checksum, n, DATASET_BINARY_EXT);
+}
+
+void sorted_snapshot_release(void) {
+    if (sorted_snapshot.valid) dataset_close(&sorted_snapshot.ds);
+    memset(&sorted_snapshot, 0, sizeof(sorted_snapshot));
+}
+
+// written under a temporary name and renamed, a crash never leaves a half snapshot behind
+int sorted_snapshot_store(const char *path, const int *sorted, int n) {
+    if (mkdir(config.cache_dir, 0755) != 0 && errno != EEXIST) {
+        printf("No se pudo crear el directorio %s\n", config.cache_dir);
+        return -1;
+    }
+    char tmp_path[MAX_PATH_LENGTH];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if (dataset_write_binary(tmp_path, sorted, n, result_context.seed) != 0) return -1;
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
     }
+    return 0;
+}
 
-    printf("\rProgreso: [");
-    for (int p = 0; p < 50; p++) printf("=");
-    printf("] 100%%\n");
+// what a snapshot costs when neither memory nor the cache has it, the hash index compares its
+// build with this
+void sorted_snapshot_sort(int *sorted, const int *arr, int n) {
+    memcpy(sorted, arr, n * sizeof(int));
+    parallel_radix_sort(sorted, n, pool_threads(config.threads));
+}
+
+// 1 when the cache already holds the snapshot of the current dataset, so it is mapped, not sorted
+int sorted_snapshot_cached(int n) {
+    if (config.cache_dir == NULL) return 0;
+    char path[MAX_PATH_LENGTH];
+    sorted_snapshot_path(result_context.checksum, n, path, sizeof(path));
+    return checkFileExists(path);
+}
+
+// sorted copy of arr, the dataset of result_context: from memory, from the cache or sorted now
+const int *sorted_snapshot_get(const int *arr, int n) {
+    if (sorted_snapshot.valid && sorted_snapshot.source_checksum == result_context.checksum && sorted_snapshot.ds.n == n) {
+        return sorted_snapshot.ds.data;
+    }
+    sorted_snapshot_release();
+
+    char path[MAX_PATH_LENGTH];
+    if (config.cache_dir != NULL) {
+        sorted_snapshot_path(result_context.checksum, n, path, sizeof(path));
+        if (checkFileExists(path) && dataset_map_binary(path, &sorted_snapshot.ds) == 0) {
+            if (sorted_snapshot.ds.n == n) {
+                printf("Usando la copia ordenada en caché %s\n", path);
+                sorted_snapshot.source_checksum = result_context.checksum;
+                sorted_snapshot.valid = 1;
+                return sorted_snapshot.ds.data;
+            }
+            dataset_close(&sorted_snapshot.ds);
+        }
+    }
+
+    int *sorted = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (sorted == NULL) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+    const uint64_t start = clock_ns();
+    sorted_snapshot_sort(sorted, arr, n);
+    printf("Array ordenado en %.3f ms.\n", (double)(clock_ns() - start) / 1e6);
+
+    if (config.cache_dir != NULL && sorted_snapshot_store(path, sorted, n) == 0) {
+        printf("Copia ordenada guardada en %s\n", path);
+    }
+    sorted_snapshot.ds.data = sorted;
+    sorted_snapshot.ds.n = n;
+    sorted_snapshot.ds.seed = result_context.seed;
+    sorted_snapshot.source_checksum = result_context.checksum;
+    sorted_snapshot.valid = 1;
+    return sorted;
+}
+
+int linear_search(const int *arr, int n, int goal) {
+    for (int i = 0; i < n; i++) {
+        if (arr[i] == goal) return i;
+    }
+    return -1;
+}
+
+int measure_linear_search(int *arr, int n, int goal) {
+    return benchmark_search("Linear Search", "Búsqueda Lineal", arr, n, goal, linear_search);
+}
+
+// ---------------------------------------------------------------------------
+// linear scans for unsorted data: the compare runs on whole vectors (AVX2 picked at runtime,
+// SSE2 or NEON otherwise), several vectors per iteration folded into one test. The parallel
+// scan splits the array across the pool and a hit cancels every slice after it. Counting all
+// the matches or collecting their positions touches every element, so those are reported as
+// bandwidth
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char *isa;
+    SearchKernel find;  // first position of goal, -1 if absent
+    SearchKernel count; // number of elements equal to goal
+} LinearScanOps;
+
+int linear_count_scalar(const int *arr, int n, int goal) {
+    int count = 0;
+    for (int i = 0; i < n; i++) count += arr[i] == goal;
+    return count;
+}
+
+#if defined(__SSE2__)
+// 16 ints per iteration, the four masks are only split apart on a hit
+int linear_search_sse2(const int *arr, int n, int goal) {
+    const __m128i key = _mm_set1_epi32(goal);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i e0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i)), key);
+        const __m128i e1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i + 4)), key);
+        const __m128i e2 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i + 8)), key);
+        const __m128i e3 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i + 12)), key);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3))) != 0) {
+            const unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e0)) |
+                                  (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e1)) << 4 |
+                                  (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e2)) << 8 |
+                                  (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e3)) << 12;
+            return i + __builtin_ctz(mask);
+        }
+    }
+    const int rest = linear_search(arr + i, n - i, goal);
+    return rest >= 0 ? i + rest : -1;
+}
+
+// a true compare is -1, subtracting it counts the lane
+int linear_count_sse2(const int *arr, int n, int goal) {
+    const __m128i key = _mm_set1_epi32(goal);
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_sub_epi32(acc0, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i)), key));
+        acc1 = _mm_sub_epi32(acc1, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i + 4)), key));
+    }
+    int lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, _mm_add_epi32(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + linear_count_scalar(arr + i, n - i, goal);
+}
+#endif
+
+#ifdef HAVE_AVX2_DISPATCH
+__attribute__((target("avx2")))
+int linear_search_avx2(const int *arr, int n, int goal) {
+    const __m256i key = _mm256_set1_epi32(goal);
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i e0 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(arr + i)), key);
+        const __m256i e1 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(arr + i + 8)), key);
+        const __m256i e2 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(arr + i + 16)), key);
+        const __m256i e3 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(arr + i + 24)), key);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+        if (!_mm256_testz_si256(any, any)) {
+            const unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e0)) |
+                                  (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e1)) << 8 |
+                                  (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e2)) << 16 |
+                                  (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e3)) << 24;
+            return i + __builtin_ctz(mask);
+        }
+    }
+    const int rest = linear_search_sse2(arr + i, n - i, goal);
+    return rest >= 0 ? i + rest : -1;
+}
+
+__attribute__((target("avx2")))
+int linear_count_avx2(const int *arr, int n, int goal) {
+    const __m256i key = _mm256_set1_epi32(goal);
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_sub_epi32(acc0, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(arr + i)), key));
+        acc1 = _mm256_sub_epi32(acc1, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(arr + i + 8)), key));
+    }
+    int lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi32(acc0, acc1));
+    int count = 0;
+    for (int l = 0; l < 8; l++) count += lanes[l];
+    return count + linear_count_sse2(arr + i, n - i, goal);
+}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+int linear_search_neon(const int *arr, int n, int goal) {
+    const int32x4_t key = vdupq_n_s32(goal);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint32x4_t e0 = vceqq_s32(vld1q_s32(arr + i), key);
+        const uint32x4_t e1 = vceqq_s32(vld1q_s32(arr + i + 4), key);
+        const uint32x4_t e2 = vceqq_s32(vld1q_s32(arr + i + 8), key);
+        const uint32x4_t e3 = vceqq_s32(vld1q_s32(arr + i + 12), key);
+        // neon has no movemask, the hit is located by the scalar loop on these 16
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(e0, e1), vorrq_u32(e2, e3))) != 0) return i + linear_search(arr + i, 16, goal);
+    }
+    const int rest = linear_search(arr + i, n - i, goal);
+    return rest >= 0 ? i + rest : -1;
+}
+
+int linear_count_neon(const int *arr, int n, int goal) {
+    const int32x4_t key = vdupq_n_s32(goal);
+    int32x4_t acc0 = vdupq_n_s32(0), acc1 = vdupq_n_s32(0);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vsubq_s32(acc0, vreinterpretq_s32_u32(vceqq_s32(vld1q_s32(arr + i), key)));
+        acc1 = vsubq_s32(acc1, vreinterpretq_s32_u32(vceqq_s32(vld1q_s32(arr + i + 4), key)));
+    }
+    return vaddvq_s32(vaddq_s32(acc0, acc1)) + linear_count_scalar(arr + i, n - i, goal);
+}
+#endif
+
+// widest scan this cpu runs, picked once since the kernels run once per query
+const LinearScanOps *linear_select_scan(void) {
+    static const LinearScanOps *selected;
+    if (selected != NULL) return selected;
+#ifdef HAVE_AVX2_DISPATCH
+    static const LinearScanOps avx2 = {"AVX2", linear_search_avx2, linear_count_avx2};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return selected = &avx2;
+#endif
+#if defined(__SSE2__)
+    static const LinearScanOps sse2 = {"SSE2", linear_search_sse2, linear_count_sse2};
+    selected = &sse2;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const LinearScanOps neon = {"NEON", linear_search_neon, linear_count_neon};
+    selected = &neon;
+#else
+    static const LinearScanOps scalar = {"escalar", linear_search, linear_count_scalar};
+    selected = &scalar;
+#endif
+    return selected;
+}
+
+int simd_linear_search(const int *arr, int n, int goal) {
+    return linear_select_scan()->find(arr, n, goal);
+}
+
+typedef struct {
+    const int *arr;
+    int n;
+    int goal;
+    const LinearScanOps *ops;
+    atomic_int first;          // lowest hit so far, INT_MAX while none
+    int *positions;            // find all: slice t writes from positions + its lo
+    int counts[MAX_THREADS];   // per slice matches for count and find all
+} ParallelScan;
+
+void parallel_scan_slice(int n, int id, int num_threads, int *lo, int *hi) {
+    *lo = (int)((long long)n * id / num_threads);
+    *hi = (int)((long long)n * (id + 1) / num_threads);
+}
+
+// scans the slice in LINEAR_BLOCK pieces and stops once a hit before the piece is known:
+// nothing here can be the first occurrence then
+void parallel_find_task(void *arg, int id, int num_threads) {
+    ParallelScan *scan = (ParallelScan *)arg;
+    int lo, hi;
+    parallel_scan_slice(scan->n, id, num_threads, &lo, &hi);
+    for (int block = lo; block < hi; block += LINEAR_BLOCK) {
+        if (atomic_load_explicit(&scan->first, memory_order_relaxed) < block) return;
+        const int len = hi - block < LINEAR_BLOCK ? hi - block : LINEAR_BLOCK;
+        const int found = scan->ops->find(scan->arr + block, len, scan->goal);
+        if (found >= 0) {
+            int current = atomic_load_explicit(&scan->first, memory_order_relaxed);
+            while (block + found < current &&
+                   !atomic_compare_exchange_weak_explicit(&scan->first, &current, block + found,
+                                                          memory_order_relaxed, memory_order_relaxed)) {}
+            return;
+        }
+    }
+}
+
+// same answer as linear_search (the first occurrence), small arrays stay on the caller
+int parallel_linear_search(const int *arr, int n, int goal) {
+    const LinearScanOps *ops = linear_select_scan();
+    kernel_threads_used = 1;
+    if (kernel_threads <= 1 || n < LINEAR_PARALLEL_MIN) return ops->find(arr, n, goal);
+
+    kernel_threads_used = kernel_threads;
+    ParallelScan scan = {.arr = arr, .n = n, .goal = goal, .ops = ops};
+    atomic_init(&scan.first, INT_MAX);
+    pool_run(kernel_threads, parallel_find_task, &scan);
+    const int first = atomic_load(&scan.first);
+    return first == INT_MAX ? -1 : first;
+}
+
+void parallel_count_task(void *arg, int id, int num_threads) {
+    ParallelScan *scan = (ParallelScan *)arg;
+    int lo, hi;
+    parallel_scan_slice(scan->n, id, num_threads, &lo, &hi);
+    scan->counts[id] = scan->ops->count(scan->arr + lo, hi - lo, scan->goal);
+}
+
+int linear_count_all(const int *arr, int n, int goal) {
+    ParallelScan scan = {.arr = arr, .n = n, .goal = goal, .ops = linear_select_scan()};
+    const int threads = pool_threads(n < LINEAR_PARALLEL_MIN ? 1 : kernel_threads);
+    kernel_threads_used = threads;
+    pool_run(threads, parallel_count_task, &scan);
+    int count = 0;
+    for (int t = 0; t < threads; t++) count += scan.counts[t];
+    return count;
+}
+
+// every hit restarts the vector scan right after it, so with few matches this stays a stream
+int linear_find_all_range(const LinearScanOps *ops, const int *arr, int lo, int hi, int goal, int *out) {
+    int count = 0;
+    for (int i = lo; i < hi;) {
+        const int found = ops->find(arr + i, hi - i, goal);
+        if (found < 0) break;
+        out[count++] = i + found;
+        i += found + 1;
+    }
+    return count;
+}
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-    write_result(alg_name, n, time_taken);
-    free(temp_arr);
-    printf("Tamaño: %d | Tiempo: %.6f segundos\n", n, time_taken);
+void parallel_find_all_task(void *arg, int id, int num_threads) {
+    ParallelScan *scan = (ParallelScan *)arg;
+    int lo, hi;
+    parallel_scan_slice(scan->n, id, num_threads, &lo, &hi);
+    scan->counts[id] = linear_find_all_range(scan->ops, scan->arr, lo, hi, scan->goal, scan->positions + lo);
 }
 
-// merge from mergesort, famous
-void merge(int *arr, int l, int m, int r, int *progress, int total_elements) {
-    int i, j, k;
-    int n1 = m - l + 1;
-    int n2 = r - m;
+// ascending positions of goal into positions (room for n), returns how many
+int linear_find_all(const int *arr, int n, int goal, int *positions) {
+    ParallelScan scan = {.arr = arr, .n = n, .goal = goal, .ops = linear_select_scan(), .positions = positions};
+    const int threads = pool_threads(n < LINEAR_PARALLEL_MIN ? 1 : kernel_threads);
+    kernel_threads_used = threads;
+    pool_run(threads, parallel_find_all_task, &scan);
+
+    // every slice wrote at its own offset, pack them in order
+    int count = 0;
+    for (int t = 0; t < threads; t++) {
+        int lo, hi;
+        parallel_scan_slice(n, t, threads, &lo, &hi);
+        memmove(positions + count, positions + lo, scan.counts[t] * sizeof(int));
+        count += scan.counts[t];
+    }
+    return count;
+}
 
-    // first copy each subarray to a separate queue then copy the values into the arrays
-    int *L = malloc(n1 * sizeof(int));
-    int *R = malloc(n2 * sizeof(int));
+// one query stream answered by the pool: every thread scans for its own slice of a chunk of
+// queries, so there is one fork-join per chunk instead of one per lookup
+typedef struct {
+    const int *arr;
+    int n;
+    const int *queries;
+    int count;
+    const LinearScanOps *ops;
+    long long found[MAX_THREADS];
+} ParallelQueryBatch;
+
+void parallel_query_batch_task(void *arg, int id, int num_threads) {
+    ParallelQueryBatch *batch = (ParallelQueryBatch *)arg;
+    int lo, hi;
+    parallel_scan_slice(batch->count, id, num_threads, &lo, &hi);
+    long long found = 0;
+    for (int q = lo; q < hi; q++) found += batch->ops->find(batch->arr, batch->n, batch->queries[q]);
+    batch->found[id] += found;
+}
 
-    if (L == NULL || R == NULL) {
+// the workload in chunks of SEARCH_CHUNK queries split over kernel_threads threads, stored with
+// the time per query of the whole chunk (throughput, there is no single latency here)
+int benchmark_parallel_query_batch(const char *alg_name, const int *arr, int n, const SearchWorkload *wl) {
+    const int chunk = config.search_cold ? SEARCH_COLD_CHUNK : SEARCH_CHUNK;
+    const int chunks = (wl->count + chunk - 1) / chunk;
+    double *samples = malloc((chunks > 0 ? chunks : 1) * sizeof(double));
+    if (samples == NULL) {
         printf("Memory allocation failed\n");
-        exit(1);
+        return -1;
     }
 
-    for (i = 0; i < n1; i++)
-        L[i] = arr[l + i];
-    for (j = 0; j < n2; j++)
-        R[j] = arr[m + 1 + j];
+    const int threads = pool_threads(kernel_threads);
+    ParallelQueryBatch batch = {.arr = arr, .n = n, .ops = linear_select_scan()};
+    memset(batch.found, 0, sizeof(batch.found));
+    kernel_threads_used = threads;
+
+    const double budget_ns = config.time_budget > 0 ? config.time_budget * 1e9 : INFINITY;
+    uint64_t spent = 0;
+    int count = 0, done = 0;
+    for (int c = -config.warmups; c < chunks && (double)spent <= budget_ns; c++) {
+        // the warmups run the first chunk untimed
+        const int first = c < 0 ? 0 : c * chunk;
+        batch.queries = wl->queries + first;
+        batch.count = first + chunk < wl->count ? chunk : wl->count - first;
+        if (config.search_cold) search_flush_caches();
+        const uint64_t start = timer_now();
+        pool_run(threads, parallel_query_batch_task, &batch);
+        const uint64_t elapsed = timer_now() - start;
+        if (c < 0) continue;
+        spent += elapsed;
+        done += batch.count;
+        samples[count++] = (double)elapsed / 1e9 / batch.count;
+    }
 
-    // merge the arrays
-    i = 0;
-    j = 0;
-    k = l;
-    while (i < n1 && j < n2) {
-        if (L[i] <= R[j]) {
-            arr[k] = L[i];
-            i++;
+    TimingStats stats;
+    compute_stats(samples, count, n, &stats);
+    write_search_result(alg_name, n, &stats);
+    printf("Consultas: %d en bloques de %d repartidos entre %d hilos | %.0f consultas/s\n", done, chunk, threads,
+           spent > 0 ? done / ((double)spent / 1e9) : 0.0);
+    free(samples);
+    return 0;
+}
+
+// times the first occurrence, count all and find all of goal over the whole array, stored as
+// "<name> Find First", "<name> Count All" and "<name> Find All"
+int benchmark_scan_modes(const char *alg_name, const int *arr, int n, int goal) {
+    int *positions = malloc((n > 0 ? n : 1) * sizeof(int));
+    double *samples = malloc(config.repetitions * sizeof(double));
+    if (positions == NULL || samples == NULL) {
+        printf("Memory allocation failed\n");
+        free(positions);
+        free(samples);
+        return -1;
+    }
+
+    static const char *const mode_names[] = {"Find First", "Count All", "Find All"};
+    static const char *const mode_labels[] = {"Primera posición", "Contar todas", "Todas las posiciones"};
+    for (int mode = 0; mode < 3; mode++) {
+        double spent = 0.0;
+        int count = 0, matches = 0;
+        kernel_threads_used = 1;
+        for (int r = 0; r < config.warmups + config.repetitions; r++) {
+            const int warmup = r < config.warmups;
+            if (spent > config.time_budget && config.time_budget > 0 && (warmup || count > 0)) {
+                if (warmup) continue;
+                break;
+            }
+            const uint64_t start = timer_now();
+            if (mode == 0) matches = parallel_linear_search(arr, n, goal);
+            else matches = mode == 1 ? linear_count_all(arr, n, goal) : linear_find_all(arr, n, goal, positions);
+            const uint64_t end = timer_now();
+
+            const double elapsed = (double)(end - start) / 1e9;
+            spent += elapsed;
+            if (!warmup) samples[count++] = elapsed;
+        }
+
+        TimingStats stats;
+        compute_stats(samples, count, n, &stats);
+        char name[MAX_NAME_LENGTH];
+        snprintf(name, sizeof(name), "%s %s", alg_name, mode_names[mode]);
+        write_search_result(name, n, &stats);
+        // the first occurrence stops early, its rate is over the elements up to the hit
+        const double scanned = mode == 0 ? (matches >= 0 ? matches + 1.0 : (double)n) : (double)n;
+        printf("%s: %d %s | Mediana: %.6f s | %.2f GB/s\n", mode_labels[mode], matches,
+               mode == 0 ? "(posición)" : "coincidencias", stats.median,
+               stats.median > 0 ? scanned * sizeof(int) / stats.median / 1e9 : 0.0);
+    }
+
+    free(samples);
+    free(positions);
+    return 0;
+}
+
+int measure_simd_linear_search(int *arr, int n, int goal) {
+    printf("Conjunto de instrucciones: %s\n", linear_select_scan()->isa);
+    if (benchmark_search("SIMD Linear Search", "Búsqueda Lineal SIMD", arr, n, goal, simd_linear_search) != 0) return -1;
+    return benchmark_scan_modes("SIMD Linear Search", arr, n, goal);
+}
+
+int measure_parallel_linear_search(int *arr, int n, int goal) {
+    char alg_name[MAX_NAME_LENGTH];
+    kernel_threads = pool_threads(config.threads);
+    snprintf(alg_name, sizeof(alg_name), "Parallel Linear Search (%dt)", kernel_threads);
+    printf("Hilos: %d | Conjunto de instrucciones: %s\n", kernel_threads, linear_select_scan()->isa);
+
+    // one scan with every thread answers goal; timing a fork-join per lookup would measure the
+    // wake-ups, so the stream is split across the threads and the single scan is timed as bandwidth
+    const int position = parallel_linear_search(arr, n, goal);
+    printf("Algoritmo: Búsqueda Lineal Paralela\n");
+    printf("Elemento %d %s\n", goal, position >= 0 ? "encontrado" : "no encontrado");
+    if (position >= 0) printf("Posición: %d\n", position);
+
+    const SearchWorkload *wl = search_workload_for(arr, n);
+    int status = wl == NULL ? -1 : benchmark_parallel_query_batch(alg_name, arr, n, wl);
+    if (status == 0) status = benchmark_scan_modes(alg_name, arr, n, goal);
+    kernel_threads = 1;
+    return status;
+}
+
+int binary_search(const int *arr, int n, int goal) {
+    int left = 0, right = n - 1;
+
+    while (left <= right) {
+        int mid = left + (right - left) / 2;
+
+        if (arr[mid] == goal) return mid;
+
+        if (arr[mid] < goal) {
+            left = mid + 1;
+        } else {
+            right = mid - 1;
+        }
+    }
+    return -1;
+}
+
+int measure_binary_search(int *arr, int n, int goal) {
+    return benchmark_search("Binary Search", "Búsqueda Binaria", arr, n, goal, binary_search);
+}
+
+int ternary_search(const int *arr, int n, int goal) {
+    int left = 0, right = n - 1;
+
+    while (left <= right) {
+        int mid1 = left + (right - left) / 3;
+        int mid2 = right - (right - left) / 3;
+
+        if (arr[mid1] == goal) return mid1;
+        if (arr[mid2] == goal) return mid2;
+
+        if (goal < arr[mid1]) {
+            right = mid1 - 1;
+        } else if (goal > arr[mid2]) {
+            left = mid2 + 1;
         } else {
-            arr[k] = R[j];
-            j++;
+            left = mid1 + 1;
+            right = mid2 - 1;
+        }
+    }
+    return -1;
+}
+
+int measure_ternary_search(int *arr, int n, int goal) {
+    return benchmark_search("Ternary Search", "Búsqueda Ternaria", arr, n, goal, ternary_search);
+}
+
+int jumping_search(const int *arr, int n, int goal) {
+    if (n <= 0) return -1;
+    const int jump = (int)sqrt(n);
+    int prev = 0;
+    int step = jump;
+
+    // jump blocks while the last element of the block is still smaller than the goal
+    while (arr[get_min(step, n) - 1] < goal) {
+        prev = step;
+        if (prev >= n) return -1;
+        step += jump;
+    }
+
+    // linear scan inside the block
+    const int end = get_min(step, n);
+    while (prev < end && arr[prev] < goal) prev++;
+
+    if (prev < end && arr[prev] == goal) return prev;
+    return -1;
+}
+
+int measure_jumping_search(int *arr, int n, int goal) {
+    return benchmark_search("Jumping Search", "Búsqueda por Saltos", arr, n, goal, jumping_search);
+}
+
+// ---------------------------------------------------------------------------
+// cache friendly binary search. Eytzinger keeps the sorted keys in bfs order (children of k at
+// 2k and 2k + 1), so the first levels share a few hot cache lines and the 16 descendants four
+// levels down are one aligned line that is prefetched while the current level is compared.
+// Both kernels turn the comparison into arithmetic instead of a branch
+// ---------------------------------------------------------------------------
+
+// in-order walk of the implicit tree, gives b[k] its rank in sorted
+int eytzinger_fill(const int *sorted, int *b, int n, int i, int k) {
+    if (k <= n) {
+        i = eytzinger_fill(sorted, b, n, i, 2 * k);
+        b[k] = sorted[i++];
+        i = eytzinger_fill(sorted, b, n, i, 2 * k + 1);
+    }
+    return i;
+}
+
+// bytes of the layout, b[0] included and rounded up to whole cache lines
+size_t eytzinger_bytes(int n) {
+    return ((size_t)(n + 1) * sizeof(int) + 63) / 64 * 64;
+}
+
+// 1-based layout of n keys, b[0] is padding so b + 16k starts a cache line
+int *eytzinger_build(const int *sorted, int n) {
+    int *b = aligned_alloc(64, eytzinger_bytes(n));
+    if (b == NULL) return NULL;
+    b[0] = INT_MIN;
+    eytzinger_fill(sorted, b, n, 0, 1);
+    return b;
+}
+
+// rank of node k from the tree shape alone, no memory access. In the perfect tree of height
+// h = log2(n) the node at depth d and offset j in its level has in-order rank
+// (2j + 1) * 2^(h - d) - 1. The leaves are the even ranks, and only the first m of them exist,
+// so every missing leaf with rank 2m, 2m + 2 ... below that rank is subtracted
+static inline int eytzinger_rank(int k, int n) {
+    const int h = 31 - __builtin_clz((unsigned)n);
+    const int d = 31 - __builtin_clz((unsigned)k);
+    const long long rank = ((2LL * (k - (1 << d)) + 1) << (h - d)) - 1;
+    const long long missing_from = 2LL * (n - (1 << h) + 1);
+    return (int)(rank < missing_from ? rank : rank - (rank - missing_from + 1) / 2);
+}
+
+// returns the position of goal in the sorted array, like the other searches, -1 if absent
+int eytzinger_search(const int *b, int n, int goal) {
+    int k = 1;
+    while (k <= n) {
+        __builtin_prefetch(b + (size_t)k * EYTZINGER_PREFETCH_SPAN);
+        k = 2 * k + (b[k] < goal);
+    }
+    // the lower bound is the last node where the walk went left: drop the trailing right turns
+    k >>= __builtin_ffs(~k);
+    return (k != 0 && b[k] == goal) ? eytzinger_rank(k, n) : -1;
+}
+
+int measure_eytzinger_search(int *arr, int n, int goal) {
+    // the stream has to come from the dataset, not from the layout
+    if (search_workload_for(arr, n) == NULL) return -1;
+
+    const uint64_t start = clock_ns();
+    int *b = eytzinger_build(arr, n);
+    const uint64_t end = clock_ns();
+    if (b == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    printf("Layout Eytzinger construido en %.3f ms | %.2f bytes por clave\n", (double)(end - start) / 1e6,
+           n > 0 ? (double)eytzinger_bytes(n) / n : 0.0);
+
+    const int status = benchmark_search("Eytzinger Search", "Búsqueda Eytzinger", b, n, goal, eytzinger_search);
+    free(b);
+    return status;
+}
+
+// lower_bound on the plain sorted array with a conditional move per level, the two possible
+// next midpoints are prefetched since the branch predictor no longer guesses one
+int branchless_search(const int *arr, int n, int goal) {
+    if (n <= 0) return -1;
+    const int *base = arr;
+    int len = n;
+    while (len > 1) {
+        const int half = len / 2;
+        const int next = (len - half) / 2;
+        __builtin_prefetch(base + next - 1);
+        __builtin_prefetch(base + half + next - 1);
+        base += (base[half - 1] < goal) * half;
+        len -= half;
+    }
+    const int index = (int)(base - arr) + (*base < goal);
+    return (index < n && arr[index] == goal) ? index : -1;
+}
+
+int measure_branchless_search(int *arr, int n, int goal) {
+    return benchmark_search("Branchless Binary Search", "Búsqueda Binaria sin Saltos", arr, n, goal, branchless_search);
+}
+
+// the typed search benchmark keeps its array here, the search kernels only carry the int keys
+static const void *typed_search_data;
+
+// each one answers an int query on the typed copy of the dataset, -1 when the key is missing
+int typed_search_i32(const int *arr, int n, int goal) {
+    (void)arr;
+    const int32_t *keys = (const int32_t *)typed_search_data;
+    const int index = typed_lower_bound(keys, n, goal);
+    return (index < n && keys[index] == goal) ? index : -1;
+}
+
+int typed_search_i64(const int *arr, int n, int goal) {
+    (void)arr;
+    const int64_t *keys = (const int64_t *)typed_search_data;
+    const int64_t key = typed_key_i64(goal);
+    const int index = typed_lower_bound(keys, n, key);
+    return (index < n && keys[index] == key) ? index : -1;
+}
+
+int typed_search_f64(const int *arr, int n, int goal) {
+    (void)arr;
+    const double *keys = (const double *)typed_search_data;
+    const double key = typed_key_f64(goal);
+    const int index = typed_lower_bound(keys, n, key);
+    return (index < n && keys[index] == key) ? index : -1;
+}
+
+int typed_search_rec8(const int *arr, int n, int goal) {
+    (void)arr;
+    const Record8 *recs = (const Record8 *)typed_search_data;
+    const int index = typed_lower_bound(recs, n, goal);
+    return (index < n && recs[index].key == goal) ? index : -1;
+}
+
+int typed_search_rec16(const int *arr, int n, int goal) {
+    (void)arr;
+    const Record16 *recs = (const Record16 *)typed_search_data;
+    const int64_t key = typed_key_i64(goal);
+    const int index = typed_lower_bound(recs, n, key);
+    return (index < n && recs[index].key == key) ? index : -1;
+}
+
+int typed_search_rec32(const int *arr, int n, int goal) {
+    (void)arr;
+    const Record32 *recs = (const Record32 *)typed_search_data;
+    const int64_t key = typed_key_i64(goal);
+    const int index = typed_lower_bound(recs, n, key);
+    return (index < n && recs[index].key == key) ? index : -1;
+}
+
+// the sorted dataset copied into the types of the typed radix sort (the key conversions keep the
+// order) and searched with their lower bound instances. Every query of the workload must give
+// the position branchless_search gives on the int array before an instance is timed
+int measure_typed_searches(int *arr, int n, int goal) {
+    int64_t *keys64 = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    double *doubles = malloc((n > 0 ? n : 1) * sizeof(double));
+    Record8 *rec8 = malloc((n > 0 ? n : 1) * sizeof(Record8));
+    Record16 *rec16 = malloc((n > 0 ? n : 1) * sizeof(Record16));
+    Record32 *rec32 = malloc((n > 0 ? n : 1) * sizeof(Record32));
+    const SearchWorkload *wl = search_workload_for(arr, n);
+    int status = 0;
+    if (keys64 == NULL || doubles == NULL || rec8 == NULL || rec16 == NULL || rec32 == NULL || wl == NULL) {
+        printf("Memory allocation failed\n");
+        status = -1;
+    }
+
+    for (int i = 0; i < n && status == 0; i++) {
+        keys64[i] = typed_key_i64(arr[i]);
+        doubles[i] = typed_key_f64(arr[i]);
+        rec8[i] = (Record8){arr[i], (uint32_t)i};
+        rec16[i] = (Record16){keys64[i], (uint64_t)i};
+        rec32[i] = (Record32){keys64[i], (uint64_t)i, {(uint64_t)i * 2, (uint64_t)i * 3}};
+    }
+
+    const struct {
+        const char *name;
+        size_t elem_size;
+        const void *data;
+        SearchKernel kernel;
+    } cases[] = {
+        {"Typed Lower Bound (int32 keys)", sizeof(int32_t), arr, typed_search_i32},
+        {"Typed Lower Bound (int64 keys)", sizeof(int64_t), keys64, typed_search_i64},
+        {"Typed Lower Bound (double keys)", sizeof(double), doubles, typed_search_f64},
+        {"Typed Lower Bound (8-byte records)", sizeof(Record8), rec8, typed_search_rec8},
+        {"Typed Lower Bound (16-byte records)", sizeof(Record16), rec16, typed_search_rec16},
+        {"Typed Lower Bound (32-byte records)", sizeof(Record32), rec32, typed_search_rec32},
+    };
+
+    if (status == 0) {
+        const int position = branchless_search(arr, n, goal);
+        printf("Algoritmo: Búsqueda Tipada\n");
+        printf("Elemento %d %s\n", goal, position >= 0 ? "encontrado" : "no encontrado");
+        if (position >= 0) printf("Posición: %d\n", position);
+    }
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]) && status == 0; c++) {
+        typed_search_data = cases[c].data;
+        int ok = cases[c].kernel(arr, n, goal) == branchless_search(arr, n, goal);
+        for (int q = 0; q < wl->count && ok; q++) {
+            ok = cases[c].kernel(arr, n, wl->queries[q]) == branchless_search(arr, n, wl->queries[q]);
+        }
+        if (!ok) {
+            printf("%s: resultado incorrecto (tamaño %d)\n", cases[c].name, n);
+            status = -1;
+            break;
+        }
+
+        TimingStats stats;
+        LatencyHistogram hist;
+        double qps;
+        if (time_search_workload(arr, n, cases[c].kernel, wl, &stats, &qps, &hist) != 0) {
+            status = -1;
+            break;
+        }
+        write_search_result(cases[c].name, n, &stats);
+        printf("%s | %zu bytes por elemento | %.0f consultas/s | p50 %.0f ns | p99 %.0f ns\n", cases[c].name,
+               cases[c].elem_size, qps, hist_percentile(&hist, 0.50), hist_percentile(&hist, 0.99));
+    }
+    typed_search_data = NULL;
+
+    free(keys64);
+    free(doubles);
+    free(rec8);
+    free(rec16);
+    free(rec32);
+    return status;
+}
+
+// ---------------------------------------------------------------------------
+// static B+ tree (S-tree): nodes of STREE_B keys, one cache line, each with STREE_B + 1 implicit
+// children, so a lookup touches log17(n) lines instead of log2(n). The leaf layer is the sorted
+// array padded with INT_MAX, every upper node key j is the smallest key of child j + 1. The layers
+// sit one after another without pointers, a header line before the keys holds their offsets.
+// The rank inside a node is a vector compare and a popcount
+// ---------------------------------------------------------------------------
+
+typedef int (*StreeRankFn)(const int *node, int goal);
+
+typedef struct {
+    const char *isa;
+    int (*lower_bound)(const int *tree, int n, int goal);
+    void (*batch)(const int *tree, int n, const int *goals, int count, int *out);
+} StreeOps;
+
+// header layout: head[0] is the height, head[1 + h] the offset of layer h (0 = leaves)
+int *stree_build(const int *sorted, int n) {
+    int nodes[STREE_MAX_HEIGHT];
+    int offset[STREE_MAX_HEIGHT];
+    int height = 1;
+    nodes[0] = n > 0 ? (n + STREE_B - 1) / STREE_B : 1;
+    offset[0] = 0;
+    while (nodes[height - 1] > 1) {
+        nodes[height] = (nodes[height - 1] + STREE_B) / (STREE_B + 1);
+        offset[height] = offset[height - 1] + nodes[height - 1] * STREE_B;
+        height++;
+    }
+    const size_t total = (size_t)offset[height - 1] + (size_t)nodes[height - 1] * STREE_B;
+
+    int *head = aligned_alloc(64, (STREE_B + total) * sizeof(int));
+    if (head == NULL) return NULL;
+    memset(head, 0, STREE_B * sizeof(int));
+    head[0] = height;
+    for (int h = 0; h < height; h++) head[1 + h] = offset[h];
+
+    int *tree = head + STREE_B;
+    memcpy(tree, sorted, n * sizeof(int));
+    for (int i = n; i < nodes[0] * STREE_B; i++) tree[i] = INT_MAX;
+
+    for (int h = 1; h < height; h++) {
+        for (int k = 0; k < nodes[h]; k++) {
+            for (int j = 0; j < STREE_B; j++) {
+                // leftmost leaf of child j + 1, h - 1 layers down
+                long long leaf = (long long)k * (STREE_B + 1) + j + 1;
+                for (int l = 1; l < h; l++) leaf *= STREE_B + 1;
+                tree[offset[h] + k * STREE_B + j] = leaf * STREE_B < n ? sorted[leaf * STREE_B] : INT_MAX;
+            }
         }
-        k++;
     }
+    return tree;
+}
+
+void stree_free(int *tree) {
+    if (tree != NULL) free(tree - STREE_B);
+}
+
+// bytes of the whole structure, header included
+size_t stree_bytes(const int *tree) {
+    const int *head = tree - STREE_B;
+    const int height = head[0];
+    size_t top = (size_t)head[height] + STREE_B;
+    return (STREE_B + top) * sizeof(int);
+}
+
+// number of keys of the node below goal
+static inline int stree_rank_scalar(const int *node, int goal) {
+    int rank = 0;
+    for (int j = 0; j < STREE_B; j++) rank += node[j] < goal;
+    return rank;
+}
+
+#if defined(__SSE2__)
+static inline int stree_rank_sse2(const int *node, int goal) {
+    const __m128i key = _mm_set1_epi32(goal);
+    const unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(key, _mm_load_si128((const __m128i *)node)))) |
+                          (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(key, _mm_load_si128((const __m128i *)(node + 4))))) << 4 |
+                          (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(key, _mm_load_si128((const __m128i *)(node + 8))))) << 8 |
+                          (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(key, _mm_load_si128((const __m128i *)(node + 12))))) << 12;
+    return __builtin_popcount(mask);
+}
+#endif
+
+#ifdef HAVE_AVX2_DISPATCH
+__attribute__((target("avx2,popcnt")))
+static inline int stree_rank_avx2(const int *node, int goal) {
+    const __m256i key = _mm256_set1_epi32(goal);
+    const __m256i lt0 = _mm256_cmpgt_epi32(key, _mm256_load_si256((const __m256i *)node));
+    const __m256i lt1 = _mm256_cmpgt_epi32(key, _mm256_load_si256((const __m256i *)(node + 8)));
+    const unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(lt0)) |
+                          (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(lt1)) << 8;
+    return __builtin_popcount(mask);
+}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+static inline int stree_rank_neon(const int *node, int goal) {
+    const int32x4_t key = vdupq_n_s32(goal);
+    // a true compare is -1 in every lane
+    int32x4_t acc = vreinterpretq_s32_u32(vcltq_s32(vld1q_s32(node), key));
+    acc = vaddq_s32(acc, vreinterpretq_s32_u32(vcltq_s32(vld1q_s32(node + 4), key)));
+    acc = vaddq_s32(acc, vreinterpretq_s32_u32(vcltq_s32(vld1q_s32(node + 8), key)));
+    acc = vaddq_s32(acc, vreinterpretq_s32_u32(vcltq_s32(vld1q_s32(node + 12), key)));
+    return -vaddvq_s32(acc);
+}
+#endif
+
+// the descents are inlined into every isa version so the rank is inlined as well
+static inline __attribute__((always_inline)) int stree_descend(const int *tree, int goal, StreeRankFn rank) {
+    const int *head = tree - STREE_B;
+    int k = 0;
+    for (int h = head[0] - 1; h > 0; h--) k = k * (STREE_B + 1) + rank(tree + head[1 + h] + k * STREE_B, goal);
+    return k * STREE_B + rank(tree + k * STREE_B, goal);
+}
 
-    // copy left array leftover elements
-    while (i < n1) {
-        arr[k] = L[i];
-        i++;
-        k++;
+// STREE_BATCH lookups walk down together, one layer at a time, so the misses of the next layer
+// overlap instead of waiting on each other
+static inline __attribute__((always_inline)) void stree_descend_batch(const int *tree, int n, const int *goals, int count,
+                                                                     int *out, StreeRankFn rank) {
+    const int *head = tree - STREE_B;
+    for (int first = 0; first < count; first += STREE_BATCH) {
+        const int m = count - first < STREE_BATCH ? count - first : STREE_BATCH;
+        int k[STREE_BATCH] = {0};
+        for (int h = head[0] - 1; h > 0; h--) {
+            const int *layer = tree + head[1 + h];
+            const int *below = tree + head[h];
+            for (int q = 0; q < m; q++) {
+                k[q] = k[q] * (STREE_B + 1) + rank(layer + k[q] * STREE_B, goals[first + q]);
+                __builtin_prefetch(below + k[q] * STREE_B);
+            }
+        }
+        for (int q = 0; q < m; q++) {
+            const int index = k[q] * STREE_B + rank(tree + k[q] * STREE_B, goals[first + q]);
+            out[first + q] = index < n && tree[index] == goals[first + q] ? index : -1;
+        }
     }
+}
+
+int stree_lower_bound_scalar(const int *tree, int n, int goal) {
+    (void)n;
+    return stree_descend(tree, goal, stree_rank_scalar);
+}
+
+void stree_batch_scalar(const int *tree, int n, const int *goals, int count, int *out) {
+    stree_descend_batch(tree, n, goals, count, out, stree_rank_scalar);
+}
+
+#if defined(__SSE2__)
+int stree_lower_bound_sse2(const int *tree, int n, int goal) {
+    (void)n;
+    return stree_descend(tree, goal, stree_rank_sse2);
+}
+
+void stree_batch_sse2(const int *tree, int n, const int *goals, int count, int *out) {
+    stree_descend_batch(tree, n, goals, count, out, stree_rank_sse2);
+}
+#endif
+
+#ifdef HAVE_AVX2_DISPATCH
+__attribute__((target("avx2,popcnt")))
+int stree_lower_bound_avx2(const int *tree, int n, int goal) {
+    (void)n;
+    return stree_descend(tree, goal, stree_rank_avx2);
+}
+
+__attribute__((target("avx2,popcnt")))
+void stree_batch_avx2(const int *tree, int n, const int *goals, int count, int *out) {
+    stree_descend_batch(tree, n, goals, count, out, stree_rank_avx2);
+}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+int stree_lower_bound_neon(const int *tree, int n, int goal) {
+    (void)n;
+    return stree_descend(tree, goal, stree_rank_neon);
+}
+
+void stree_batch_neon(const int *tree, int n, const int *goals, int count, int *out) {
+    stree_descend_batch(tree, n, goals, count, out, stree_rank_neon);
+}
+#endif
+
+const StreeOps *stree_select(void) {
+    static const StreeOps *selected;
+    if (selected != NULL) return selected;
+#ifdef HAVE_AVX2_DISPATCH
+    static const StreeOps avx2 = {"AVX2", stree_lower_bound_avx2, stree_batch_avx2};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return selected = &avx2;
+#endif
+#if defined(__SSE2__)
+    static const StreeOps sse2 = {"SSE2", stree_lower_bound_sse2, stree_batch_sse2};
+    selected = &sse2;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const StreeOps neon = {"NEON", stree_lower_bound_neon, stree_batch_neon};
+    selected = &neon;
+#else
+    static const StreeOps scalar = {"escalar", stree_lower_bound_scalar, stree_batch_scalar};
+    selected = &scalar;
+#endif
+    return selected;
+}
+
+// first index whose key is >= goal, n when there is none
+int stree_lower_bound(const int *tree, int n, int goal) {
+    return stree_select()->lower_bound(tree, n, goal);
+}
+
+int stree_search(const int *tree, int n, int goal) {
+    const int index = stree_select()->lower_bound(tree, n, goal);
+    return index < n && tree[index] == goal ? index : -1;
+}
+
+// out[i] = stree_search(tree, n, goals[i])
+void stree_search_batch(const int *tree, int n, const int *goals, int count, int *out) {
+    stree_select()->batch(tree, n, goals, count, out);
+}
 
-    // copy right array leftover elements
-    while (j < n2) {
-        arr[k] = R[j];
-        j++;
-        k++;
+// the workload again through the batch lookup, only throughput: single latencies do not exist here
+int benchmark_stree_batch(const char *alg_name, const int *tree, int n, const SearchWorkload *wl) {
+    int *out = malloc(wl->count * sizeof(int));
+    double *samples = malloc(config.repetitions * sizeof(double));
+    if (out == NULL || samples == NULL) {
+        printf("Memory allocation failed\n");
+        free(out);
+        free(samples);
+        return -1;
     }
 
-    free(L);
-    free(R);
-
-    // update progress (processed range processed)
-    int current_progress = ((r - l) * 100) / total_elements;
-    if (current_progress > *progress) {
-        *progress = current_progress;
-        printf("\rProgreso: [");
-        for (int p = 0; p < 50; p++) {
-            if (p < current_progress/2) printf("=");
-            else printf(" ");
+    double spent = 0.0;
+    int count = 0;
+    kernel_threads_used = 1;
+    for (int r = 0; r < config.warmups + config.repetitions; r++) {
+        const int warmup = r < config.warmups;
+        if (spent > config.time_budget && config.time_budget > 0 && (warmup || count > 0)) {
+            if (warmup) continue;
+            break;
         }
-        printf("] %d%%", current_progress);
-        fflush(stdout);
+        if (config.search_cold) search_flush_caches();
+        const uint64_t start = timer_now();
+        stree_search_batch(tree, n, wl->queries, wl->count, out);
+        const uint64_t end = timer_now();
+
+        const double elapsed = (double)(end - start) / 1e9;
+        spent += elapsed;
+        if (!warmup) samples[count++] = elapsed / wl->count;
     }
-}
 
-// "divide-and-conquer" mergesort routine plus progress sfollowup
-void merge_sort_recursive(int *arr, int l, int r, int *progress, int total_elements) {
+    int hits = 0;
+    for (int q = 0; q < wl->count; q++) hits += out[q] >= 0;
 
-    int middle;
-    if (l < r) {
-        middle = l + (r - l) / 2;
-        merge_sort_recursive(arr, l, middle, progress, total_elements);
-        merge_sort_recursive(arr, middle + 1, r, progress, total_elements);
-        merge(arr, l, middle, r, progress, total_elements);
-    }
+    TimingStats stats;
+    compute_stats(samples, count, n, &stats);
+    write_search_result(alg_name, n, &stats);
+    printf("Lotes de %d: %d aciertos | %.0f consultas/s\n", STREE_BATCH, hits, stats.median > 0 ? 1.0 / stats.median : 0.0);
+
+    free(samples);
+    free(out);
+    return 0;
 }
 
-void measure_merge_sort(int *arr, int n) {
-    double time_taken;
-    const char *alg_name = "Merge Sort";
+int measure_stree_search(int *arr, int n, int goal) {
+    const SearchWorkload *wl = search_workload_for(arr, n);
+    if (wl == NULL) return -1;
 
-    // Create a temporary copy to preserve original array
-    int *temp_arr = malloc(n * sizeof(int));
-    if (temp_arr == NULL) {
+    const uint64_t start = clock_ns();
+    int *tree = stree_build(arr, n);
+    const uint64_t end = clock_ns();
+    if (tree == NULL) {
         printf("Memory allocation failed\n");
-        exit(1);
+        return -1;
     }
-    memcpy(temp_arr, arr, n * sizeof(int));
+    printf("Árbol S construido en %.3f ms | %d niveles | %.2f bytes por clave | %s\n", (double)(end - start) / 1e6,
+           tree[-STREE_B], n > 0 ? (double)stree_bytes(tree) / n : 0.0, stree_select()->isa);
 
-    printf("\nProgreso: [");
-    for (int p = 0; p < 50; p++) printf(" ");
-    printf("] 0%%");
-    fflush(stdout);
-
-    int progress = 0;
-    clock_t start = clock();
+    int status = benchmark_search("S-Tree Search", "Búsqueda en Árbol S", tree, n, goal, stree_search);
+    if (status == 0) status = benchmark_stree_batch("S-Tree Search Batch", tree, n, wl);
+    stree_free(tree);
+    return status;
+}
 
-    // Call the recursive merge sort, this like a parent function, kinda broke ma head
-    merge_sort_recursive(temp_arr, 0, n - 1, &progress, n);
+// ---------------------------------------------------------------------------
+// searches that use the key values: the generator spreads the keys uniformly over
+// [10,000,000, 99,999,999], so a key's position is almost a linear function of its value.
+// Interpolation search probes where the key should be and hands over to binary search when the
+// probes stop halving the range. The radix spline learns that function once: spline points
+// within RS_MAX_ERROR positions of every key, found through a radix table on the top bits of
+// the key, then a binary search inside the error window
+// ---------------------------------------------------------------------------
 
-    printf("\rProgreso: [");
-    for (int p = 0; p < 50; p++) printf("=");
-    printf("] 100%%\n");
-
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-    write_result(alg_name, n, time_taken);
-    free(temp_arr);
-    printf("Tamaño: %d | Tiempo: %.6f segundos\n", n, time_taken);
-}
-
-void compare_and_swap(int *a, int *b, int dir) {
-    if ((*a > *b && dir) || (*a < *b && !dir)) {
-        int temp = *a;
-        *a = *b;
-        *b = temp;
-    }
-}
-
-// merge bitonic "sequences"
-void bitonic_merge(int *arr, int low, int cnt, int dir, int *progress, int total_elements) {
-    if (cnt > 1) {
-        int k = cnt / 2;
-        for (int i = low; i < low + k; i++) {
-            compare_and_swap(&arr[i], &arr[i + k], dir);
-        }
-        bitonic_merge(arr, low, k, dir, progress, total_elements);
-        bitonic_merge(arr, low + k, k, dir, progress, total_elements);
-
-        // update progress here, I can not tell if I am doing this righht
-        int current_progress = ((low + cnt) * 100) / total_elements;
-        if (current_progress > *progress) {
-            *progress = current_progress;
-            printf("\rProgreso: [");
-            for (int p = 0; p < 50; p++) {
-                if (p < current_progress/2) printf("=");
-                else printf(" ");
-            }
-            printf("] %d%%", current_progress);
-            fflush(stdout);
+int interpolation_search(const int *arr, int n, int goal) {
+    int left = 0, right = n - 1;
+    int slow = 0;
+    while (left <= right && goal >= arr[left] && goal <= arr[right]) {
+        if (arr[left] == arr[right]) return arr[left] == goal ? left : -1;
+        // the guard: skewed keys make the probes crawl, binary search takes the rest
+        if (right - left < INTERPOLATION_MIN_RANGE || slow > INTERPOLATION_SLOW_PROBES) {
+            const int found = binary_search(arr + left, right - left + 1, goal);
+            return found >= 0 ? left + found : -1;
         }
+
+        const int size = right - left;
+        const int pos = left + (int)((double)((long long)goal - arr[left]) * size / ((double)arr[right] - arr[left]));
+        if (arr[pos] == goal) return pos;
+        if (arr[pos] < goal) left = pos + 1;
+        else right = pos - 1;
+        if (right - left > size / 2) slow++;
     }
+    return -1;
 }
 
-// recursuve bitonic sort call (supposed to be a sequential version)
-void bitonic_sort_recursive(int *arr, int low, int cnt, int dir, int *progress, int total_elements) {
-    if (cnt > 1) {
-        int k = cnt / 2;
+typedef struct {
+    int key;
+    int pos;
+} SplinePoint;
+
+typedef struct {
+    SplinePoint *points;
+    int count;
+    int *table;        // table[p] = first point whose key prefix is >= p
+    int radix_bits;
+    int shift;
+    int min_key;
+    int max_key;
+    const int *keys;   // the array the model was built from
+} RadixSpline;
+
+// the lookup kernel has the plain search signature, so it reads the model built for its array here
+static RadixSpline radix_spline;
+
+void radix_spline_free(RadixSpline *rs) {
+    free(rs->points);
+    free(rs->table);
+    memset(rs, 0, sizeof(*rs));
+}
 
-        // ascendant ordering
-        bitonic_sort_recursive(arr, low, k, 1, progress, total_elements);
+// cross product sign of (b - a) and (c - a): > 0 when c is left of the line a-b
+static inline double spline_orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
 
-        // desdendant
-        bitonic_sort_recursive(arr, low + k, k, 0, progress, total_elements);
+// greedy spline corridor over the distinct keys (position = first occurrence), a point is added
+// when the next key cannot be reached from the last point within +-RS_MAX_ERROR
+int radix_spline_build(RadixSpline *rs, const int *sorted, int n) {
+    radix_spline_free(rs);
+    if (n <= 0) return 0;
+    rs->keys = sorted;
+    rs->points = malloc(n * sizeof(SplinePoint));
+    if (rs->points == NULL) return -1;
+
+    rs->points[rs->count++] = (SplinePoint){sorted[0], 0};
+    double base_x = sorted[0], base_y = 0;
+    double upper_x = 0, upper_y = 0, lower_x = 0, lower_y = 0;
+    int have_corridor = 0;
+    int prev_key = sorted[0], prev_pos = 0;
 
-        // merge the sequence, very similir a merge sort
-        bitonic_merge(arr, low, cnt, dir, progress, total_elements);
+    for (int i = 1; i < n; i++) {
+        if (sorted[i] == prev_key) continue;
+        const double x = sorted[i], y = i;
+        if (!have_corridor) {
+            upper_x = lower_x = x;
+            upper_y = y + RS_MAX_ERROR;
+            lower_y = y - RS_MAX_ERROR;
+            have_corridor = 1;
+        } else if (spline_orientation(base_x, base_y, upper_x, upper_y, x, y) > 0 ||
+                   spline_orientation(base_x, base_y, lower_x, lower_y, x, y) < 0) {
+            // outside the corridor: the previous key becomes a spline point
+            rs->points[rs->count++] = (SplinePoint){prev_key, prev_pos};
+            base_x = prev_key;
+            base_y = prev_pos;
+            upper_x = lower_x = x;
+            upper_y = y + RS_MAX_ERROR;
+            lower_y = y - RS_MAX_ERROR;
+        } else {
+            if (spline_orientation(base_x, base_y, upper_x, upper_y, x, y + RS_MAX_ERROR) < 0) {
+                upper_x = x;
+                upper_y = y + RS_MAX_ERROR;
+            }
+            if (spline_orientation(base_x, base_y, lower_x, lower_y, x, y - RS_MAX_ERROR) > 0) {
+                lower_x = x;
+                lower_y = y - RS_MAX_ERROR;
+            }
+        }
+        prev_key = sorted[i];
+        prev_pos = i;
+    }
+    if (rs->points[rs->count - 1].key != prev_key) rs->points[rs->count++] = (SplinePoint){prev_key, prev_pos};
+
+    // about two spline points per radix slot
+    rs->min_key = sorted[0];
+    rs->max_key = sorted[n - 1];
+    const uint32_t range = (uint32_t)((long long)rs->max_key - rs->min_key);
+    const int range_bits = range == 0 ? 0 : 32 - __builtin_clz(range);
+    int bits = 1;
+    while (bits < RS_MAX_RADIX_BITS && (1 << bits) < rs->count) bits++;
+    rs->radix_bits = bits < range_bits ? bits : range_bits;
+    rs->shift = range_bits - rs->radix_bits;
+
+    const int slots = (1 << rs->radix_bits) + 1;
+    rs->table = malloc((slots + 1) * sizeof(int));
+    if (rs->table == NULL) {
+        radix_spline_free(rs);
+        return -1;
     }
+    int p = 0;
+    for (int i = 0; i < rs->count; i++) {
+        const int prefix = (int)((uint32_t)((long long)rs->points[i].key - rs->min_key) >> rs->shift);
+        while (p <= prefix) rs->table[p++] = i;
+    }
+    while (p <= slots) rs->table[p++] = rs->count;
+    return 0;
 }
 
-// thread function for the sort
-void* bitonic_sort_thread(void *arg) {
-    BitonicParams *params = (BitonicParams *)arg;
-    bitonic_sort_recursive(params->arr, params->low, params->cnt, params->dir,
-                          params->progress, params->total_elements);
-    return NULL;
+// bytes of the model on top of the keys
+size_t radix_spline_bytes(const RadixSpline *rs) {
+    return (size_t)rs->count * sizeof(SplinePoint) + ((size_t)(1 << rs->radix_bits) + 2) * sizeof(int);
 }
 
-void concurrent_bitonic_sort(int *arr, int n, int *progress) {
-    const int num_threads = 4; // Número de hilos a usar
-    pthread_t threads[num_threads];
-    BitonicParams params[num_threads];
-
-    int chunk_size = n / num_threads;
-    for (int i = 0; i < num_threads; i++) {
-        params[i].arr = arr;
-        params[i].low = i * chunk_size;
-        params[i].cnt = (i == num_threads - 1) ? (n - i * chunk_size) : chunk_size;
-        params[i].dir = 1;
-        params[i].progress = progress;
-        params[i].total_elements = n;
-
-        pthread_create(&threads[i], NULL, bitonic_sort_thread, &params[i]);
+int learned_search(const int *arr, int n, int goal) {
+    const RadixSpline *rs = &radix_spline;
+    if (n <= 0 || goal < rs->min_key || goal > rs->max_key) return -1;
+
+    // spline points of this prefix, plus the first one of the next prefix (its key is larger)
+    const int prefix = (int)((uint32_t)((long long)goal - rs->min_key) >> rs->shift);
+    int lo = rs->table[prefix];
+    int hi = rs->table[prefix + 1];
+    if (hi > rs->count - 1) hi = rs->count - 1;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (rs->points[mid].key < goal) lo = mid + 1;
+        else hi = mid;
     }
 
-    for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], NULL);
+    int estimate;
+    const SplinePoint *right = &rs->points[lo];
+    if (right->key == goal || lo == 0) {
+        estimate = right->pos;
+    } else {
+        const SplinePoint *left = &rs->points[lo - 1];
+        estimate = left->pos + (int)((double)((long long)goal - left->key) * (right->pos - left->pos) /
+                                     ((double)right->key - left->key));
     }
 
-    bitonic_merge(arr, 0, n, 1, progress, n);
+    // lower_bound inside the error window
+    int first = estimate - RS_MAX_ERROR - 1 > 0 ? estimate - RS_MAX_ERROR - 1 : 0;
+    int last = estimate + RS_MAX_ERROR + 2 < n ? estimate + RS_MAX_ERROR + 2 : n;
+    while (first < last) {
+        const int mid = first + (last - first) / 2;
+        if (arr[mid] < goal) first = mid + 1;
+        else last = mid;
+    }
+    return first < n && arr[first] == goal ? first : -1;
 }
 
-void measure_bitonic_sort(int *arr, int n) {
-    double time_taken;
-    const char *alg_name = "Bitonic Sort";
-
-    // Para arrays grandes, estimar basado en 10k elementos
-    // if (n == 100000 || n == 1000000) {
-    if (n == 0) {
+// the skewed copy of the sorted keys: t -> t^SEARCH_SKEW_POWER over the key range keeps the
+// order but packs most keys at the low end, where interpolation guesses badly
+int *search_skewed_keys(const int *sorted, int n) {
+    int *keys = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (keys == NULL) return NULL;
+    const double lo = sorted[0], span = (double)sorted[n - 1] - sorted[0];
+    for (int i = 0; i < n; i++) {
+        const double t = span > 0 ? (sorted[i] - lo) / span : 0.0;
+        keys[i] = (int)(lo + span * pow(t, SEARCH_SKEW_POWER));
+    }
+    return keys;
+}
 
-        double time_10k;
+// kernel and binary search again on the skewed keys, stored as "<name> (skewed)" with the
+// distribution of the results set to skewed. prepare builds what the kernel needs, may be NULL
+int benchmark_search_skewed(const char *alg_name, const char *label, const int *sorted, int n, SearchKernel kernel,
+                            int (*prepare)(const int *keys, int n)) {
+    if (n <= 0) return 0;
+    int *keys = search_skewed_keys(sorted, n);
+    if (keys == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
 
-        if (!read_result(alg_name, 10000, &time_10k)) {
-            printf("Ejecuta primero las pruebas de 10 mil elementos.\n");
-            return;
-        }
+    // skewed keys of a generated distribution keep its name in the tag
+    static char skewed_tag[MAX_NAME_LENGTH];
+    const ResultContext saved = result_context;
+    result_context.checksum = dataset_checksum(keys, (size_t)n);
+    result_context.distribution = "skewed";
+    if (strcmp(saved.distribution, "uniform") != 0) {
+        snprintf(skewed_tag, sizeof(skewed_tag), "%s+skewed", saved.distribution);
+        result_context.distribution = skewed_tag;
+    }
+    const int goal = keys[(int)(generator_random(result_context.checksum, 0) % (uint64_t)n)];
+    printf("\n--- Claves sesgadas (t^%d) ---\n", SEARCH_SKEW_POWER);
+
+    char name[MAX_NAME_LENGTH];
+    int status = 0;
+    if (prepare != NULL) status = prepare(keys, n);
+    if (status == 0) {
+        snprintf(name, sizeof(name), "%s (skewed)", alg_name);
+        status = benchmark_search(name, label, keys, n, goal, kernel);
+    }
+    if (status == 0) status = benchmark_search("Binary Search (skewed)", "Búsqueda Binaria", keys, n, goal, binary_search);
 
-        /*----------------------------------------------------------
-          Explicación de la estimación:
-          - Bitonic Sort es O(n log²n)
-          - Para 100,000: (100000 log²100000)/(10000 log²10000) ≈ 14.5
-          - Para 1,000,000: (1000000 log²1000000)/(10000 log²10000) ≈ 217
-        ----------------------------------------------------------*/
-        double factor;
-        if (n == 100000) factor = 14.5;
-        else factor = 217.0;
+    result_context = saved;
+    free(keys);
+    return status;
+}
 
-        time_taken = time_10k * factor;
-        write_result(alg_name, n, time_taken);
-        printf("Tamaño: %d | Tiempo estimado: %.6f segundos\n", n, time_taken);
-        return;
-    }
+int measure_interpolation_search(int *arr, int n, int goal) {
+    if (benchmark_search("Interpolation Search", "Búsqueda por Interpolación", arr, n, goal, interpolation_search) != 0) return -1;
+    return benchmark_search_skewed("Interpolation Search", "Búsqueda por Interpolación", arr, n, interpolation_search, NULL);
+}
 
-    // ccreate a temporary copy to preserve original array
-    int *temp_arr = malloc(n * sizeof(int));
-    if (temp_arr == NULL) {
+// builds radix_spline for keys and reports it
+int learned_prepare(const int *keys, int n) {
+    const uint64_t start = clock_ns();
+    if (radix_spline_build(&radix_spline, keys, n) != 0) {
         printf("Memory allocation failed\n");
-        exit(1);
+        return -1;
     }
-    memcpy(temp_arr, arr, n * sizeof(int));
+    const uint64_t end = clock_ns();
+    printf("Radix spline construido en %.3f ms | %d puntos | %d bits de radix | %.3f bytes por clave\n",
+           (double)(end - start) / 1e6, radix_spline.count, radix_spline.radix_bits,
+           n > 0 ? (double)radix_spline_bytes(&radix_spline) / n : 0.0);
+    return 0;
+}
 
-    printf("\nProgreso: [");
-    for (int p = 0; p < 50; p++) printf(" ");
-    printf("] 0%%");
-    fflush(stdout);
+int measure_learned_search(int *arr, int n, int goal) {
+    int status = learned_prepare(arr, n);
+    if (status == 0) status = benchmark_search("Learned Index Search", "Índice Aprendido (Radix Spline)", arr, n, goal, learned_search);
+    if (status == 0) status = benchmark_search_skewed("Learned Index Search", "Índice Aprendido (Radix Spline)", arr, n, learned_search, learned_prepare);
+    radix_spline_free(&radix_spline);
+    return status;
+}
 
-    int progress = 0;
-    clock_t start = clock();
+// ---------------------------------------------------------------------------
+// hash index for membership on the unsorted data, no sort needed. Open addressing with linear
+// probing and one control byte per slot (HASH_EMPTY or 7 bits of the hash), 16 control bytes are
+// matched at once. The table is split in partitions by the top bits of the hash so the pool
+// builds them in parallel without atomics: count per partition, scatter in dataset order, then
+// every partition is filled by one thread. An optional blocked Bloom filter (8 words of 32 bits
+// per block, one bit per word) in front rejects most misses with one cache line read
+// ---------------------------------------------------------------------------
 
-    // choose between sequential or concurrential version
-    if (n >= 10000) {
-        // generally used for "big" arrays
-        concurrent_bitonic_sort(temp_arr, n, &progress);
-    } else {
-        // used for "small" arrays
-        bitonic_sort_recursive(temp_arr, 0, n, 1, &progress, n);
-    }
+typedef struct {
+    int key;
+    int pos; // first occurrence in the dataset
+} HashSlot;
 
-    printf("\rProgreso: [");
-    for (int p = 0; p < 50; p++) printf("=");
-    printf("] 100%%\n");
+typedef struct {
+    unsigned char *ctrl; // capacity + HASH_GROUP bytes per partition, the first group is cloned at the end
+    HashSlot *slots;
+    uint32_t *bloom;     // BLOOM_WORDS words per block, NULL without the filter
+    int partition_bits;
+    int capacity;        // slots per partition, power of two
+    int bloom_blocks;    // blocks per partition, power of two
+    size_t bytes;
+} HashIndex;
+
+// the lookup kernels have the plain search signature, so they read the index built for their array here
+static HashIndex hash_index;
+
+static const uint32_t bloom_salt[BLOOM_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+static inline uint64_t hash_key(int key) {
+    return mix64((uint32_t)key);
+}
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-    write_result(alg_name, n, time_taken);
-    free(temp_arr);
-    printf("Tamaño: %d | Tiempo: %.6f segundos\n", n, time_taken);
+static inline int hash_partition(const HashIndex *index, uint64_t h) {
+    return index->partition_bits > 0 ? (int)(h >> (64 - index->partition_bits)) : 0;
 }
 
-void measure_linear_search(int *arr, int n, int goal) {
-    double time_taken;
-    const char *alg_name = "Linear Search";
+static inline uint32_t *bloom_block(const HashIndex *index, int part, uint64_t h) {
+    return index->bloom + ((size_t)part * index->bloom_blocks + ((h >> 32) & (uint64_t)(index->bloom_blocks - 1))) * BLOOM_WORDS;
+}
 
-    clock_t start = clock();
+void bloom_insert(HashIndex *index, int part, uint64_t h) {
+    uint32_t *block = bloom_block(index, part, h);
+    for (int w = 0; w < BLOOM_WORDS; w++) block[w] |= 1U << (((uint32_t)h * bloom_salt[w]) >> 27);
+}
 
-    int found = 0;
-    int position = -1;
-    for (int i = 0; i < n; i++) {
-        if (arr[i] == goal) {
-            found = 1;
-            position = i;
-            break;
-        }
+int bloom_may_contain(const HashIndex *index, int part, uint64_t h) {
+    const uint32_t *block = bloom_block(index, part, h);
+    uint32_t missing = 0;
+    for (int w = 0; w < BLOOM_WORDS; w++) {
+        const uint32_t bit = 1U << (((uint32_t)h * bloom_salt[w]) >> 27);
+        missing |= bit & ~block[w];
     }
+    return missing == 0;
+}
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+// keeps the first occurrence, later duplicates are dropped
+void hash_insert(HashIndex *index, int part, uint64_t h, int key, int pos) {
+    unsigned char *ctrl = index->ctrl + (size_t)part * (index->capacity + HASH_GROUP);
+    HashSlot *slots = index->slots + (size_t)part * index->capacity;
+    const unsigned char tag = (unsigned char)(h & 0x7f);
+    const size_t mask = (size_t)index->capacity - 1;
+    for (size_t i = (h >> 7) & mask;; i = (i + 1) & mask) {
+        if (ctrl[i] == HASH_EMPTY) {
+            ctrl[i] = tag;
+            if (i < HASH_GROUP) ctrl[index->capacity + i] = tag;
+            slots[i].key = key;
+            slots[i].pos = pos;
+            return;
+        }
+        if (ctrl[i] == tag && slots[i].key == key) return;
+    }
+}
 
-    write_search_result(alg_name, n, time_taken);
+static inline int hash_lookup(const HashIndex *index, int part, uint64_t h, int key) {
+    const unsigned char *ctrl = index->ctrl + (size_t)part * (index->capacity + HASH_GROUP);
+    const HashSlot *slots = index->slots + (size_t)part * index->capacity;
+    const unsigned char tag = (unsigned char)(h & 0x7f);
+    const size_t mask = (size_t)index->capacity - 1;
+    // a key sits before the first empty slot after its home, so a group with an empty ends the probe
+    for (size_t i = (h >> 7) & mask;; i = (i + HASH_GROUP) & mask) {
+#if defined(__SSE2__)
+        const __m128i group = _mm_loadu_si128((const __m128i *)(ctrl + i));
+        unsigned match = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+        while (match != 0) {
+            const size_t slot = (i + __builtin_ctz(match)) & mask;
+            if (slots[slot].key == key) return slots[slot].pos;
+            match &= match - 1;
+        }
+        if (_mm_movemask_epi8(group) != 0) return -1;
+#else
+        int empty = 0;
+        for (int b = 0; b < HASH_GROUP; b++) {
+            const size_t slot = (i + b) & mask;
+            if (ctrl[i + b] == tag && slots[slot].key == key) return slots[slot].pos;
+            empty |= ctrl[i + b] == HASH_EMPTY;
+        }
+        if (empty) return -1;
+#endif
+    }
+}
 
-    printf("Algoritmo: Búsqueda Lineal\n");
-    printf("Elemento %d %s\n", goal, found ? "encontrado" : "no encontrado");
-    if (found) printf("Posición: %d\n", position);
-    printf("Tiempo: %.6f segundos\n", time_taken);
+int hash_search(const int *arr, int n, int goal) {
+    (void)arr;
+    (void)n;
+    const uint64_t h = hash_key(goal);
+    return hash_lookup(&hash_index, hash_partition(&hash_index, h), h, goal);
 }
 
-void measure_binary_search(int *arr, int n, int goal) {
-    double time_taken;
-    const char *alg_name = "Binary Search";
+int bloom_hash_search(const int *arr, int n, int goal) {
+    (void)arr;
+    (void)n;
+    const uint64_t h = hash_key(goal);
+    const int part = hash_partition(&hash_index, h);
+    if (!bloom_may_contain(&hash_index, part, h)) return -1;
+    return hash_lookup(&hash_index, part, h, goal);
+}
 
-    clock_t start = clock();
+void hash_index_free(HashIndex *index) {
+    free(index->ctrl);
+    free(index->slots);
+    free(index->bloom);
+    memset(index, 0, sizeof(*index));
+}
 
-    int left = 0, right = n - 1;
-    int found = 0, position = -1;
+typedef struct {
+    const int *arr;
+    int n;
+    int parts;
+    int *counts;      // [thread][partition], then the scatter offsets
+    HashSlot *entries; // the dataset grouped by partition, dataset order inside each
+    HashIndex *index;
+} HashBuild;
+
+void hash_count_task(void *arg, int id, int num_threads) {
+    HashBuild *build = (HashBuild *)arg;
+    int lo, hi;
+    parallel_scan_slice(build->n, id, num_threads, &lo, &hi);
+    int *counts = build->counts + (size_t)id * build->parts;
+    for (int i = lo; i < hi; i++) counts[hash_partition(build->index, hash_key(build->arr[i]))]++;
+}
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
+void hash_scatter_task(void *arg, int id, int num_threads) {
+    HashBuild *build = (HashBuild *)arg;
+    int lo, hi;
+    parallel_scan_slice(build->n, id, num_threads, &lo, &hi);
+    int *offsets = build->counts + (size_t)id * build->parts;
+    for (int i = lo; i < hi; i++) {
+        const int p = hash_partition(build->index, hash_key(build->arr[i]));
+        build->entries[offsets[p]++] = (HashSlot){build->arr[i], i};
+    }
+}
 
-        if (arr[mid] == goal) {
-            found = 1;
-            position = mid;
-            break;
+void hash_fill_task(void *arg, int id, int num_threads) {
+    HashBuild *build = (HashBuild *)arg;
+    HashIndex *index = build->index;
+    // after the scatter, offsets of the last thread are the partition ends
+    const int *ends = build->counts + (size_t)(num_threads - 1) * build->parts;
+    for (int p = id; p < build->parts; p += num_threads) {
+        const int first = p == 0 ? 0 : ends[p - 1];
+        for (int e = first; e < ends[p]; e++) {
+            const uint64_t h = hash_key(build->entries[e].key);
+            hash_insert(index, p, h, build->entries[e].key, build->entries[e].pos);
+            if (index->bloom != NULL) bloom_insert(index, p, h);
         }
+    }
+}
 
-        if (arr[mid] < goal) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+// returns the thread count the build really used (small inputs run on one), -1 when out of memory
+int hash_index_build(HashIndex *index, const int *arr, int n, int threads, int with_bloom) {
+    hash_index_free(index);
+    threads = pool_threads(n < HASH_PARALLEL_MIN ? 1 : threads);
+    int bits = 0;
+    while (threads > 1 && (1 << bits) < threads * HASH_PARTITIONS_PER_THREAD && bits < HASH_MAX_PARTITION_BITS) bits++;
+    index->partition_bits = bits;
+
+    HashBuild build = {arr, n, 1 << bits, NULL, NULL, index};
+    build.counts = calloc((size_t)threads * build.parts, sizeof(int));
+    build.entries = malloc((n > 0 ? n : 1) * sizeof(HashSlot));
+    if (build.counts == NULL || build.entries == NULL) {
+        free(build.counts);
+        free(build.entries);
+        return -1;
+    }
+    pool_run(threads, hash_count_task, &build);
+
+    // sizes from the fullest partition, then the counts become scatter offsets
+    int largest = 0, offset = 0;
+    for (int p = 0; p < build.parts; p++) {
+        int total = 0;
+        for (int t = 0; t < threads; t++) {
+            const int count = build.counts[(size_t)t * build.parts + p];
+            build.counts[(size_t)t * build.parts + p] = offset;
+            offset += count;
+            total += count;
         }
+        if (total > largest) largest = total;
     }
-
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-
-    write_search_result(alg_name, n, time_taken);
-
-    printf("Algoritmo: Búsqueda Binaria\n");
-    printf("Elemento %d %s\n", goal, found ? "encontrado" : "no encontrado");
-    if (found) printf("Posición: %d\n", position);
-    printf("Tiempo: %.6f segundos\n", time_taken);
+    index->capacity = HASH_GROUP;
+    while ((long long)index->capacity * HASH_MAX_LOAD_NUM < (long long)largest * HASH_MAX_LOAD_DEN + 1) index->capacity *= 2;
+    index->bloom_blocks = 1;
+    while ((long long)index->bloom_blocks * BLOOM_WORDS * 32 < (long long)largest * BLOOM_BITS_PER_KEY) index->bloom_blocks *= 2;
+
+    const size_t ctrl_bytes = (size_t)build.parts * (index->capacity + HASH_GROUP);
+    const size_t slot_bytes = (size_t)build.parts * index->capacity * sizeof(HashSlot);
+    const size_t bloom_bytes = with_bloom ? (size_t)build.parts * index->bloom_blocks * BLOOM_WORDS * sizeof(uint32_t) : 0;
+    index->ctrl = malloc(ctrl_bytes);
+    index->slots = malloc(slot_bytes);
+    // blocks are 32 bytes, aligned they never straddle a cache line
+    index->bloom = with_bloom ? aligned_alloc(BLOOM_WORDS * sizeof(uint32_t), bloom_bytes) : NULL;
+    if (index->ctrl == NULL || index->slots == NULL || (with_bloom && index->bloom == NULL)) {
+        free(build.counts);
+        free(build.entries);
+        hash_index_free(index);
+        return -1;
+    }
+    memset(index->ctrl, HASH_EMPTY, ctrl_bytes);
+    if (with_bloom) memset(index->bloom, 0, bloom_bytes);
+    index->bytes = ctrl_bytes + slot_bytes + bloom_bytes;
+
+    pool_run(threads, hash_scatter_task, &build);
+    pool_run(threads, hash_fill_task, &build);
+    free(build.counts);
+    free(build.entries);
+    return threads;
 }
 
-void measure_ternary_search(int *arr, int n, int goal) {
-    double time_taken;
-    const char *alg_name = "Ternary Search";
-
-    clock_t start = clock();
-
-    int left = 0, right = n - 1;
-    int found = 0, position = -1;
+// what one build of a lookup structure needs, timed by time_index_build
+typedef struct {
+    const int *arr;
+    int n;
+    int *copy;      // the sorted snapshot baseline sorts into this copy
+    int threads;    // hash build: requested
+    int with_bloom;
+} IndexBuild;
+
+// the sort of sorted_snapshot_get on a cache miss, parallel_radix_sort sets kernel_threads_used
+int sorted_snapshot_build(IndexBuild *build) {
+    sorted_snapshot_sort(build->copy, build->arr, build->n);
+    return 0;
+}
 
-    while (left <= right) {
-        int mid1 = left + (right - left) / 3;
-        int mid2 = right - (right - left) / 3;
+int hash_index_build_run(IndexBuild *build) {
+    const int used = hash_index_build(&hash_index, build->arr, build->n, build->threads, build->with_bloom);
+    if (used < 0) return -1;
+    kernel_threads_used = used;
+    return 0;
+}
 
-        if (arr[mid1] == goal) {
-            found = 1;
-            position = mid1;
+// warmups and repetitions of a build within the time budget, like time_typed_sort
+int time_index_build(int (*run)(IndexBuild *build), IndexBuild *build, TimingStats *stats) {
+    double *samples = malloc(config.repetitions * sizeof(double));
+    kernel_threads_used = 1;
+    if (samples == NULL) return -1;
+
+    double spent = 0.0;
+    int count = 0, status = 0;
+    for (int r = 0; r < config.warmups + config.repetitions; r++) {
+        const int warmup = r < config.warmups;
+        if (spent > config.time_budget && config.time_budget > 0 && (warmup || count > 0)) {
+            if (warmup) continue;
             break;
         }
-
-        if (arr[mid2] == goal) {
-            found = 1;
-            position = mid2;
+        const uint64_t start = timer_now();
+        if (run(build) != 0) {
+            status = -1;
             break;
         }
-
-        if (goal < arr[mid1]) {
-            right = mid1 - 1;
-        } else if (goal > arr[mid2]) {
-            left = mid2 + 1;
-        } else {
-            left = mid1 + 1;
-            right = mid2 - 1;
-        }
+        const double elapsed = (double)(timer_now() - start) / 1e9;
+        spent += elapsed;
+        if (!warmup) samples[count++] = elapsed;
     }
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-
-    write_search_result(alg_name, n, time_taken);
-
-    printf("Algoritmo: Búsqueda Ternaria\n");
-    printf("Elemento %d %s\n", goal, found ? "encontrado" : "no encontrado");
-    if (found) printf("Posición: %d\n", position);
-    printf("Tiempo: %.6f segundos\n", time_taken);
+    compute_stats(samples, count, build->n, stats);
+    free(samples);
+    return status;
 }
 
-void measure_jumping_search(int *arr, int n, int goal) {
-    double time_taken;
-    const char *alg_name = "Jumping Search";
-
-    clock_t start = clock();
-
-    int step = sqrt(n);
-    int prev = 0;
-    int found = 0, position = -1;
-
-    while (arr[get_min(step, n) - 1] < goal) {
-        prev = step;
-        step += sqrt(n);
-        if (prev >= n) break;
-    }
-
-    while (arr[prev] < goal) {
-        prev++;
-        if (prev == get_min(step, n)) break;
+// the build costs go to the results log as build entries, "<name> Build" and "Sorted Snapshot
+// Build (parallel radix)", with the memory kept per key in the bytes_per_element column. The
+// baseline is what the sorted-array searches pay for their snapshot when the cache misses
+int benchmark_hash_index(const char *alg_name, const char *label, int *arr, int n, int goal, int with_bloom) {
+    // what the sorted-array searches pay before their first lookup, for comparison
+    IndexBuild build = {arr, n, malloc((n > 0 ? n : 1) * sizeof(int)), pool_threads(config.threads), with_bloom};
+    TimingStats sort_stats, build_stats;
+    if (build.copy == NULL || time_index_build(sorted_snapshot_build, &build, &sort_stats) != 0 ||
+        time_index_build(hash_index_build_run, &build, &build_stats) != 0) {
+        printf("Memory allocation failed\n");
+        free(build.copy);
+        hash_index_free(&hash_index);
+        return -1;
     }
-
-    if (arr[prev] == goal) {
-        found = 1;
-        position = prev;
+    free(build.copy);
+
+    char build_name[MAX_NAME_LENGTH];
+    snprintf(build_name, sizeof(build_name), "%s Build", alg_name);
+    sort_stats.bytes_per_element = sizeof(int);
+    build_stats.bytes_per_element = n > 0 ? (double)hash_index.bytes / n : 0.0;
+    write_build_result("Sorted Snapshot Build (parallel radix)", n, &sort_stats);
+    write_build_result(build_name, n, &build_stats);
+    printf("Índice hash construido en %.3f ms (%d hilos, %d particiones) | %.2f bytes por clave\n", build_stats.median * 1e3,
+           build_stats.threads, 1 << hash_index.partition_bits, build_stats.bytes_per_element);
+    printf("Copia ordenada sin caché (radix paralelo, %d hilos): %.3f ms%s\n", sort_stats.threads, sort_stats.median * 1e3,
+           sorted_snapshot_cached(n) ? " | ya está en caché, las búsquedas ordenadas no vuelven a ordenar" : "");
+
+    int status = benchmark_search(alg_name, label, arr, n, goal, with_bloom ? bloom_hash_search : hash_search);
+    const SearchWorkload *wl = search_workload_for(arr, n);
+    if (status == 0 && with_bloom && wl != NULL && wl->count > wl->hits) {
+        int rejected = 0;
+        for (int q = 0; q < wl->count; q++) {
+            const uint64_t h = hash_key(wl->queries[q]);
+            rejected += !bloom_may_contain(&hash_index, hash_partition(&hash_index, h), h);
+        }
+        printf("Filtro Bloom: %.2f%% de los fallos descartados sin tocar la tabla\n",
+               100.0 * rejected / (wl->count - wl->hits));
     }
+    hash_index_free(&hash_index);
+    return status;
+}
 
-    clock_t end = clock();
-    time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-
-    write_search_result(alg_name, n, time_taken);
+int measure_hash_search(int *arr, int n, int goal) {
+    return benchmark_hash_index("Hash Index Search", "Índice Hash", arr, n, goal, 0);
+}
 
-    printf("Algoritmo: Búsqueda por Saltos\n");
-    printf("Elemento %d %s\n", goal, found ? "encontrado" : "no encontrado");
-    if (found) printf("Posición: %d\n", position);
-    printf("Tiempo: %.6f segundos\n", time_taken);
+int measure_bloom_hash_search(int *arr, int n, int goal) {
+    return benchmark_hash_index("Bloom + Hash Index Search", "Índice Hash con Filtro Bloom", arr, n, goal, 1);
 }
 
 // handles the user input
@@ -1003,8 +5691,9 @@ void fileFiller() {
         printf("1. Generar 10,000 números (archivo: datos_10k.txt)\n");
         printf("2. Generar 100,000 números (archivo: datos_100k.txt)\n");
         printf("3. Generar 1,000,000 números (archivo: datos_1M.txt)\n");
-        printf("4. Salir\n");
-        printf("Seleccione una opción (1-4): ");
+        printf("4. Convertir los archivos de texto a formato binario (.bin)\n");
+        printf("5. Salir\n");
+        printf("Seleccione una opción (1-5): ");
 
         // Read input as string
         if (fgets(input, sizeof(input), stdin) == NULL) {
@@ -1030,9 +5719,9 @@ void fileFiller() {
             printf("Error: Número fuera de rango. Intente de nuevo.\n");
             continue;
         }
-        if (option < 1 || option > 4) {
+        if (option < 1 || option > 5) {
             printf("--------------------------------------------------\n");
-            printf("Error: La opción debe ser entre 1 y 4. Intente de nuevo.\n");
+            printf("Error: La opción debe ser entre 1 y 5. Intente de nuevo.\n");
             continue;
         }
 
@@ -1047,7 +5736,14 @@ void fileFiller() {
             case 3:
                 generateFileOfNumbers(DATOS1M, 1000000);
                 break;
-            case 4:
+            case 4: {
+                const char *filenames[] = {DATOS10K, DATOS100K, DATOS1M};
+                for (int i = 0; i < 3; i++) {
+                    if (checkFileExists(filenames[i])) convert_text_dataset(filenames[i]);
+                }
+                break;
+            }
+            case 5:
                 printf("\n");
                 printf("Volviendo al menú principal...\n");
                 return;
@@ -1102,39 +5798,26 @@ void menu() {
                 break;
             case 6:
                 printf("Saliendo del programa...\n");
+                results_export();
+                results_close();
+                sorted_snapshot_release();
+                registry_close_all();
+                work_buffers_release();
                 exit(0);
         }
     }
 }
 
-int get_random_number_from_file(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (!file) return -1;
-
-    int count = 0;
-    char ch;
-    while ((ch = fgetc(file)) != EOF) {
-        if (ch == '\n') count++;
-    }
-
-    if (count == 0) {
-        fclose(file);
-        return -1;
-    }
-
-    rewind(file);
-    int random_index = rand() % count;
-    int number = -1;
-
-    for (int i = 0; i <= random_index; i++) {
-        if (fscanf(file, "%d", &number) != 1) {
-            number = -1;
-            break;
-        }
+// one key of the dataset from the seeded generator, --seed makes the picks reproducible
+int sample_dataset_key(const Dataset *ds) {
+    static uint64_t seed;
+    static uint64_t draws;
+    static int seeded;
+    if (!seeded) {
+        seed = config.seed_set ? config.seed : generator_fresh_seed();
+        seeded = 1;
     }
-
-    fclose(file);
-    return number;
+    return ds->data[generator_random(seed, draws++) % (uint64_t)ds->n];
 }
 
 int compare_ints(const void *a, const void *b) {
@@ -1155,12 +5838,11 @@ void searchBenchmark() {
 
     while (1) {
         printf("\n=== MENÚ DE BÚSQUEDA ===\n");
-        printf("1. Búsqueda Lineal\n");
-        printf("2. Búsqueda Binaria (requiere array ordenado)\n");
-        printf("3. Búsqueda Ternaria (requiere array ordenado)\n");
-        printf("4. Búsqueda por Saltos\n");
-        printf("5. Volver al menú principal\n");
-        printf("Seleccione un algoritmo (1-5): ");
+        for (int a = 0; a < NUM_SEARCH_ALGORITHMS; a++) {
+            printf("%d. %s\n", a + 1, search_algorithms[a].label);
+        }
+        printf("%d. Volver al menú principal\n", NUM_SEARCH_ALGORITHMS + 1);
+        printf("Seleccione un algoritmo (1-%d): ", NUM_SEARCH_ALGORITHMS + 1);
 
         if (fgets(input, sizeof(input), stdin) == NULL) {
             printf("Error leyendo entrada.\n");
@@ -1171,12 +5853,13 @@ void searchBenchmark() {
         const long int option = strtol(input, &endptr, 10);
 
         if (endptr == input || (*endptr != '\n' && *endptr != '\0') ||
-            errno == ERANGE || option < 1 || option > 5) {
+            errno == ERANGE || option < 1 || option > NUM_SEARCH_ALGORITHMS + 1) {
             printf("Entrada inválida. Intente de nuevo.\n");
             continue;
         }
 
-        if (option == 5) return;
+        if (option == NUM_SEARCH_ALGORITHMS + 1) return;
+        const SearchAlgorithm *alg = &search_algorithms[option - 1];
 
         while (1) {
             printf("\n=== SELECCIÓN DEL NÚMERO A BUSCAR ===\n");
@@ -1201,11 +5884,12 @@ void searchBenchmark() {
             }
 
             if (search_option >= 1 && search_option <= 3) {
-                goal = get_random_number_from_file(filenames[search_option - 1]);
-                if (goal == -1) {
+                const Dataset *ds = checkFileExists(filenames[search_option - 1]) ? registry_open(filenames[search_option - 1]) : NULL;
+                if (ds == NULL || ds->n == 0) {
                     printf("Error al obtener número aleatorio. Genere los archivos primero.\n");
                     continue;
                 }
+                goal = sample_dataset_key(ds);
                 use_random = 1;
                 printf("Número aleatorio seleccionado: %d\n", goal);
             } else {
@@ -1235,43 +5919,22 @@ void searchBenchmark() {
                 continue;
             }
 
-            int n;
-            int *arr = loadArrayFromFile(filenames[i], &n);
-            if (arr == NULL) continue;
-
-            // ordered array is needed
-            if (option == 2 || option == 3 || option == 4) {
-                printf("\nOrdenando el array para búsqueda binaria/ternaria/saltos...\n");
-                int *temp_arr = malloc(n * sizeof(int));
-                if (temp_arr == NULL) {
-                    printf("Error: No se pudo asignar memoria para el array temporal\n");
-                    free(arr);
-                    continue;
-                }
-                memcpy(temp_arr, arr, n * sizeof(int));
-                qsort(temp_arr, n, sizeof(int), compare_ints);
-                free(arr);
-                arr = temp_arr;
-                printf("Array ordenado correctamente.\n");
+            const Dataset *ds = registry_open(filenames[i]);
+            if (ds == NULL) continue;
+            results_set_dataset(ds);
+            int n = ds->n;
+            int *arr = ds->data;
+
+            // ordered array is needed, shared with the other searches of this dataset
+            if (alg->needs_sorted) {
+                printf("\n");
+                arr = (int *)sorted_snapshot_get(ds->data, n);
+                if (arr == NULL) continue;
             }
 
             printf("\n--- Archivo: %s ---\n", filenames[i]);
 
-            switch (option) {
-                case 1:
-                    measure_linear_search(arr, n, goal);
-                    break;
-                case 2:
-                    measure_binary_search(arr, n, goal);
-                    break;
-                case 3:
-                    measure_ternary_search(arr, n, goal);
-                    break;
-                case 4:
-                    measure_jumping_search(arr, n, goal);
-                    break;
-            }
-            free(arr);
+            alg->measure(arr, n, goal);
             // using the same random number
             // if (use_random) break;
         }
@@ -1285,14 +5948,11 @@ void sortingBenchmark() {
 
     while (1) {
         printf("\n=== SELECCIONE ALGORITMO ===\n");
-        printf("1. Bubble Sort\n");
-        printf("2. Quick Sort\n");
-        printf("3. Stooge Sort\n");
-        printf("4. Radix Sort\n");
-        printf("5. Merge Sort\n");
-        printf("6. Bitonic Sort\n");
-        printf("7. Volver al menú principal\n");
-        printf("Seleccione una opción (1-7): ");
+        for (int a = 0; a < NUM_SORT_ALGORITHMS; a++) {
+            printf("%d. %s\n", a + 1, sort_algorithms[a].name);
+        }
+        printf("%d. Volver al menú principal\n", NUM_SORT_ALGORITHMS + 1);
+        printf("Seleccione una opción (1-%d): ", NUM_SORT_ALGORITHMS + 1);
 
         if (fgets(input, sizeof(input), stdin) == NULL) {
             printf("Error leyendo entrada.\n");
@@ -1303,12 +5963,13 @@ void sortingBenchmark() {
         const long int option = strtol(input, &endptr, 10);
 
         if (endptr == input || (*endptr != '\n' && *endptr != '\0') ||
-            errno == ERANGE || option < 1 || option > 7) {
+            errno == ERANGE || option < 1 || option > NUM_SORT_ALGORITHMS + 1) {
             printf("Entrada inválida. Intente de nuevo.\n");
             continue;
             }
 
-        if (option == 7) return;
+        if (option == NUM_SORT_ALGORITHMS + 1) return;
+        const SortAlgorithm *alg = &sort_algorithms[option - 1];
 
         const char *filenames[] = {DATOS10K, DATOS100K, DATOS1M};
 
@@ -1320,36 +5981,405 @@ void sortingBenchmark() {
                 return;
             }
 
-            int n;
-            int *arr = loadArrayFromFile(filenames[i], &n);
-            if (arr == NULL) continue;
-
-            switch (option) {
-                case 1:
-                    measure_bubble_sort(arr, n);
-                    break;
-                case 2:
-                    measure_quick_sort(arr, n);
-                    break;
-                case 3:
-                    measure_stooge_sort(arr, n);
-                    break;
-                case 4:
-                    measure_radix_sort(arr, n);
-                    break;
-                case 5:
-                    measure_merge_sort(arr, n);
-                    break;
-                case 6:
-                    measure_bitonic_sort(arr, n);
-                    break;
+            const Dataset *ds = registry_open(filenames[i]);
+            if (ds == NULL) continue;
+            results_set_dataset(ds);
+
+            alg->measure(ds->data, ds->n);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// batch mode: same measure_* kernels, driven by argv instead of the menus
+// ---------------------------------------------------------------------------
+
+void print_usage(const char *prog) {
+    printf("Uso: %s [opciones]\n", prog);
+    printf("Sin opciones se abre el menú interactivo.\n\n");
+    printf("  --menu               abre el menú interactivo con los ajustes de las demás opciones\n");
+    printf("  --sort LISTA         algoritmos de ordenamiento separados por coma, o 'all'\n");
+    printf("  --search LISTA       algoritmos de búsqueda separados por coma, o 'all'\n");
+    printf("  --data RUTAS         archivos de datos separados por coma\n");
+    printf("  --sizes LISTA        tamaños, usa data/datos_<n>.txt y lo genera si no existe\n");
+    printf("  --generate LISTA     genera (o regenera) los archivos de esos tamaños\n");
+    printf("  --dist LISTA         distribuciones separadas por coma, o 'all': cada una se genera en memoria para\n");
+    printf("                       cada tamaño de --sizes (matriz distribución x tamaño) en lugar de leer archivos\n");
+    printf("  --convert RUTAS      convierte archivos de texto al formato binario (.bin)\n");
+    printf("  --populate           precarga las páginas de los archivos binarios al mapearlos\n");
+    printf("  --hugepages          pide páginas grandes para los archivos mapeados\n");
+    printf("  --verify             valida el checksum de los archivos binarios al abrirlos\n");
+    printf("  --binary             los archivos generados se escriben en formato binario\n");
+    printf("  --threads N          hilos para la generación y los algoritmos paralelos (defecto: número de CPUs)\n");
+    printf("  --pin                fija cada hilo del pool a un núcleo (Linux)\n");
+    printf("  --reps N             repeticiones medidas por algoritmo y archivo (defecto %d)\n", DEFAULT_REPETITIONS);
+    printf("  --warmup N           repeticiones descartadas antes de medir (defecto %d)\n", DEFAULT_WARMUPS);
+    printf("  --queries N          consultas por algoritmo y archivo (defecto %d)\n", DEFAULT_SEARCH_QUERIES);
+    printf("  --hit-ratio F        fracción de consultas que existen en los datos (defecto %.2f)\n", DEFAULT_HIT_RATIO);
+    printf("  --hot-ratio F        fracción de los aciertos dirigida a las claves calientes (defecto %.2f)\n", DEFAULT_HOT_RATIO);
+    printf("  --hot-keys N         número de claves calientes (defecto %d)\n", DEFAULT_HOT_KEYS);
+    printf("  --zipf S             los aciertos siguen una zipf de exponente S sobre las claves (0: conjunto caliente)\n");
+    printf("  --sorted-queries     las consultas se ejecutan en orden ascendente\n");
+    printf("  --cold               vacía las cachés antes de cada bloque de consultas\n");
+    printf("  --budget S           deja de repetir tras S segundos medidos, 0 sin límite (defecto %.0f)\n", DEFAULT_TIME_BUDGET);
+    printf("  --tsc                mide con rdtsc calibrado en lugar de CLOCK_MONOTONIC_RAW (x86)\n");
+    printf("  --seed N             semilla para la generación y la elección de objetivos\n");
+    printf("  --target N           número a buscar (defecto: uno aleatorio del archivo)\n");
+    printf("  --output RUTA        csv de resultados de ordenamiento (defecto %s)\n", RESULTS_FILE);
+    printf("  --search-output RUTA csv de resultados de búsqueda (defecto %s)\n", SEARCH_RESULTS_FILE);
+    printf("  --log RUTA           registro de todas las mediciones, los csv se exportan de él (defecto %s)\n", RESULTS_LOG);
+    printf("  --cache DIR          copias ordenadas y archivos de consultas de las búsquedas (defecto %s)\n", SNAPSHOT_DIR);
+    printf("  --no-cache           ordena los datos y genera las consultas en cada ejecución sin guardarlos\n");
+    printf("  -h, --help           muestra esta ayuda\n\n");
+    printf("Ordenamiento:");
+    for (int a = 0; a < NUM_SORT_ALGORITHMS; a++) printf(" %s", sort_algorithms[a].key);
+    printf("\nBúsqueda:");
+    for (int a = 0; a < NUM_SEARCH_ALGORITHMS; a++) printf(" %s", search_algorithms[a].key);
+    printf("\nDistribuciones:");
+    for (int d = 0; d < NUM_DISTRIBUTIONS; d++) printf(" %s", distributions[d].key);
+    printf("\n");
+}
+
+// parses a whole decimal argument within [min, max], same checks as the menus
+int parse_long_arg(const char *text, long min, long max, long *out) {
+    char *endptr;
+    errno = 0;
+    const long value = strtol(text, &endptr, 10);
+    if (endptr == text || *endptr != '\0' || errno == ERANGE || value < min || value > max) {
+        return 0;
+    }
+    *out = value;
+    return 1;
+}
+
+int parse_double_arg(const char *text, double min, double max, double *out) {
+    char *endptr;
+    errno = 0;
+    const double value = strtod(text, &endptr);
+    if (endptr == text || *endptr != '\0' || errno == ERANGE || !(value >= min && value <= max)) {
+        return 0;
+    }
+    *out = value;
+    return 1;
+}
+
+// splits a comma separated argument in place
+int split_list(char *text, char **items, int max_items) {
+    int count = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(text, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        if (count == max_items) return -1;
+        items[count++] = tok;
+    }
+    return count;
+}
+
+// the three historical sizes keep their file names, anything else goes to data/datos_<n>.txt
+// with --binary the generated file is the .bin sibling, dataset_open finds it from the text name
+void dataset_path_for_size(int n, char *path, size_t len) {
+    char text_path[MAX_PATH_LENGTH];
+    if (n == 10000) snprintf(text_path, sizeof(text_path), "%s", DATOS10K);
+    else if (n == 100000) snprintf(text_path, sizeof(text_path), "%s", DATOS100K);
+    else if (n == 1000000) snprintf(text_path, sizeof(text_path), "%s", DATOS1M);
+    else snprintf(text_path, sizeof(text_path), "data/datos_%d.txt", n);
+
+    if (config.binary_datasets) dataset_binary_path(text_path, path, len);
+    else snprintf(path, len, "%s", text_path);
+}
+
+// the selected algorithms on one dataset, returns how many failed. goal NULL samples one from the data
+int batch_run_dataset(const Dataset *ds, const SortAlgorithm **sorts, int sort_count, const SearchAlgorithm **searches,
+                      int search_count, const int *goal) {
+    int failures = 0;
+    int n = ds->n;
+    int *arr = ds->data;
+
+    for (int a = 0; a < sort_count; a++) {
+        printf("\n%s\n", sorts[a]->name);
+        if (sorts[a]->measure(arr, n) != 0) failures++;
+    }
+
+    if (search_count > 0) {
+        int needs_sorted = 0;
+        for (int a = 0; a < search_count; a++) needs_sorted |= searches[a]->needs_sorted;
+
+        int *sorted = needs_sorted ? (int *)sorted_snapshot_get(arr, n) : NULL;
+        if (needs_sorted && sorted == NULL) return failures + 1;
+
+        const int file_goal = goal != NULL ? *goal : sample_dataset_key(ds);
+        for (int a = 0; a < search_count; a++) {
+            printf("\n");
+            if (searches[a]->measure(searches[a]->needs_sorted ? sorted : arr, n, file_goal) != 0) failures++;
+        }
+    }
+    return failures;
+}
+
+int run_batch(int argc, char **argv) {
+    char *sort_keys[MAX_LIST_ITEMS], *search_keys[MAX_LIST_ITEMS];
+    char *data_paths[MAX_LIST_ITEMS], *size_items[MAX_LIST_ITEMS], *generate_items[MAX_LIST_ITEMS];
+    char *convert_paths[MAX_LIST_ITEMS], *dist_keys[MAX_LIST_ITEMS];
+    int num_sort = 0, num_search = 0, num_data = 0, num_sizes = 0, num_generate = 0, num_convert = 0, num_dist = 0;
+    int have_target = 0, goal = 0, open_menu = 0;
+    long value;
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        if (strcmp(opt, "-h") == 0 || strcmp(opt, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(opt, "--menu") == 0) { open_menu = 1; continue; }
+        if (strcmp(opt, "--populate") == 0) { config.map_populate = 1; continue; }
+        if (strcmp(opt, "--hugepages") == 0) { config.map_hugepages = 1; continue; }
+        if (strcmp(opt, "--verify") == 0) { config.verify_checksum = 1; continue; }
+        if (strcmp(opt, "--binary") == 0) { config.binary_datasets = 1; continue; }
+        if (strcmp(opt, "--tsc") == 0) { config.use_tsc = 1; continue; }
+        if (strcmp(opt, "--pin") == 0) { config.pin_threads = 1; continue; }
+        if (strcmp(opt, "--cold") == 0) { config.search_cold = 1; continue; }
+        if (strcmp(opt, "--no-cache") == 0) { config.cache_dir = NULL; continue; }
+        if (strcmp(opt, "--sorted-queries") == 0) { config.queries_sorted = 1; continue; }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Opción desconocida o sin valor: %s\n", opt);
+            return EXIT_USAGE;
+        }
+        char *arg = argv[++i];
+        int count = 0;
+
+        if (strcmp(opt, "--sort") == 0) {
+            count = num_sort = split_list(arg, sort_keys, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--search") == 0) {
+            count = num_search = split_list(arg, search_keys, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--data") == 0) {
+            count = num_data = split_list(arg, data_paths, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--sizes") == 0) {
+            count = num_sizes = split_list(arg, size_items, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--generate") == 0) {
+            count = num_generate = split_list(arg, generate_items, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--convert") == 0) {
+            count = num_convert = split_list(arg, convert_paths, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--dist") == 0) {
+            count = num_dist = split_list(arg, dist_keys, MAX_LIST_ITEMS);
+        } else if (strcmp(opt, "--reps") == 0) {
+            if (!parse_long_arg(arg, 1, INT_MAX, &value)) count = -1;
+            else { config.repetitions = (int)value; count = 1; }
+        } else if (strcmp(opt, "--warmup") == 0) {
+            if (!parse_long_arg(arg, 0, INT_MAX, &value)) count = -1;
+            else { config.warmups = (int)value; count = 1; }
+        } else if (strcmp(opt, "--queries") == 0 || strcmp(opt, "--search-reps") == 0) {
+            if (!parse_long_arg(arg, 1, INT_MAX, &value)) count = -1;
+            else { config.search_queries = (int)value; count = 1; }
+        } else if (strcmp(opt, "--hit-ratio") == 0) {
+            if (!parse_double_arg(arg, 0.0, 1.0, &config.hit_ratio)) count = -1;
+            else count = 1;
+        } else if (strcmp(opt, "--hot-ratio") == 0) {
+            if (!parse_double_arg(arg, 0.0, 1.0, &config.hot_ratio)) count = -1;
+            else count = 1;
+        } else if (strcmp(opt, "--zipf") == 0) {
+            if (!parse_double_arg(arg, 0.0, 10.0, &config.zipf)) count = -1;
+            else count = 1;
+        } else if (strcmp(opt, "--hot-keys") == 0) {
+            if (!parse_long_arg(arg, 1, 1 << 24, &value)) count = -1;
+            else { config.hot_keys = (int)value; count = 1; }
+        } else if (strcmp(opt, "--budget") == 0) {
+            if (!parse_long_arg(arg, 0, INT_MAX, &value)) count = -1;
+            else { config.time_budget = (double)value; count = 1; }
+        } else if (strcmp(opt, "--seed") == 0) {
+            if (!parse_long_arg(arg, 0, LONG_MAX, &value)) count = -1;
+            else { config.seed = (uint64_t)value; config.seed_set = 1; count = 1; }
+        } else if (strcmp(opt, "--threads") == 0) {
+            if (!parse_long_arg(arg, 1, MAX_THREADS, &value)) count = -1;
+            else { config.threads = (int)value; count = 1; }
+        } else if (strcmp(opt, "--target") == 0) {
+            if (!parse_long_arg(arg, INT_MIN, INT_MAX, &value)) count = -1;
+            else { goal = (int)value; have_target = 1; count = 1; }
+        } else if (strcmp(opt, "--output") == 0) {
+            config.results_file = arg;
+            count = 1;
+        } else if (strcmp(opt, "--search-output") == 0) {
+            config.search_results_file = arg;
+            count = 1;
+        } else if (strcmp(opt, "--log") == 0) {
+            config.results_log = arg;
+            count = 1;
+        } else if (strcmp(opt, "--cache") == 0) {
+            config.cache_dir = arg;
+            count = 1;
+        } else {
+            fprintf(stderr, "Opción desconocida: %s\n", opt);
+            return EXIT_USAGE;
+        }
+
+        if (count <= 0) {
+            fprintf(stderr, "Valor inválido para %s: %s\n", opt, arg);
+            return EXIT_USAGE;
+        }
+    }
+
+    // the menu takes the settings parsed above (threads, repetitions, files...), not the lists
+    if (open_menu) {
+        if (config.use_tsc) timer_calibrate();
+        pool_start(config.threads, config.pin_threads);
+        menu();
+        pool_stop();
+        return 0;
+    }
+
+    // resolve the algorithm names before doing any work, a typo should not cost a whole sweep
+    const SortAlgorithm *sorts[MAX_LIST_ITEMS];
+    const SearchAlgorithm *searches[MAX_LIST_ITEMS];
+    int sort_count = 0, search_count = 0;
+
+    for (int k = 0; k < num_sort; k++) {
+        if (strcmp(sort_keys[k], "all") == 0) {
+            for (int a = 0; a < NUM_SORT_ALGORITHMS && sort_count < MAX_LIST_ITEMS; a++) {
+                sorts[sort_count++] = &sort_algorithms[a];
+            }
+            continue;
+        }
+        int a = 0;
+        while (a < NUM_SORT_ALGORITHMS && strcmp(sort_algorithms[a].key, sort_keys[k]) != 0) a++;
+        if (a == NUM_SORT_ALGORITHMS) {
+            fprintf(stderr, "Algoritmo de ordenamiento desconocido: %s\n", sort_keys[k]);
+            return EXIT_USAGE;
+        }
+        sorts[sort_count++] = &sort_algorithms[a];
+    }
+    for (int k = 0; k < num_search; k++) {
+        if (strcmp(search_keys[k], "all") == 0) {
+            for (int a = 0; a < NUM_SEARCH_ALGORITHMS && search_count < MAX_LIST_ITEMS; a++) {
+                searches[search_count++] = &search_algorithms[a];
+            }
+            continue;
+        }
+        int a = 0;
+        while (a < NUM_SEARCH_ALGORITHMS && strcmp(search_algorithms[a].key, search_keys[k]) != 0) a++;
+        if (a == NUM_SEARCH_ALGORITHMS) {
+            fprintf(stderr, "Algoritmo de búsqueda desconocido: %s\n", search_keys[k]);
+            return EXIT_USAGE;
+        }
+        searches[search_count++] = &search_algorithms[a];
+    }
+
+    const Distribution *dists[MAX_LIST_ITEMS];
+    int dist_count = 0;
+    for (int k = 0; k < num_dist; k++) {
+        if (strcmp(dist_keys[k], "all") == 0) {
+            for (int d = 0; d < NUM_DISTRIBUTIONS && dist_count < MAX_LIST_ITEMS; d++) dists[dist_count++] = &distributions[d];
+            continue;
+        }
+        const Distribution *dist = distribution_find(dist_keys[k]);
+        if (dist == NULL) {
+            fprintf(stderr, "Distribución desconocida: %s\n", dist_keys[k]);
+            return EXIT_USAGE;
+        }
+        dists[dist_count++] = dist;
+    }
+    if (dist_count > 0 && num_sizes == 0) {
+        fprintf(stderr, "--dist necesita los tamaños de --sizes.\n");
+        return EXIT_USAGE;
+    }
+
+    if (config.use_tsc) timer_calibrate();
+    // the workers exist before the first measurement, no kernel pays for creating them
+    pool_start(config.threads, config.pin_threads);
+
+    int failures = 0;
+    char paths[2 * MAX_LIST_ITEMS][MAX_PATH_LENGTH];
+    int num_paths = 0;
+
+    for (int k = 0; k < num_generate; k++) {
+        if (!parse_long_arg(generate_items[k], 1, INT_MAX, &value)) {
+            fprintf(stderr, "Tamaño inválido: %s\n", generate_items[k]);
+            return EXIT_USAGE;
+        }
+        dataset_path_for_size((int)value, paths[0], MAX_PATH_LENGTH);
+        if (generateFileOfNumbers(paths[0], (int)value) != 0) failures++;
+    }
+
+    for (int k = 0; k < num_convert; k++) {
+        if (convert_text_dataset(convert_paths[k]) != 0) failures++;
+    }
+
+    // with --dist the sizes belong to the matrix and no file is read or written for them
+    int matrix_sizes[MAX_LIST_ITEMS];
+    int num_matrix = 0;
+    const uint64_t matrix_seed = config.seed_set ? config.seed : generator_fresh_seed();
+    for (int k = 0; k < num_sizes; k++) {
+        if (!parse_long_arg(size_items[k], 1, INT_MAX, &value)) {
+            fprintf(stderr, "Tamaño inválido: %s\n", size_items[k]);
+            return EXIT_USAGE;
+        }
+        if (dist_count > 0) {
+            matrix_sizes[num_matrix++] = (int)value;
+            continue;
+        }
+        dataset_path_for_size((int)value, paths[num_paths], MAX_PATH_LENGTH);
+        char bin_path[MAX_PATH_LENGTH];
+        dataset_binary_path(paths[num_paths], bin_path, sizeof(bin_path));
+        if (!checkFileExists(paths[num_paths]) && !checkFileExists(bin_path) &&
+            generateFileOfNumbers(paths[num_paths], (int)value) != 0) {
+            failures++;
+            continue;
+        }
+        num_paths++;
+    }
+    for (int k = 0; k < num_data; k++) {
+        snprintf(paths[num_paths++], MAX_PATH_LENGTH, "%s", data_paths[k]);
+    }
+
+    if ((sort_count > 0 || search_count > 0) && num_paths == 0 && num_matrix == 0) {
+        fprintf(stderr, "Indique los datos con --data o --sizes.\n");
+        return EXIT_USAGE;
+    }
+
+    for (int p = 0; p < num_paths; p++) {
+        if (sort_count == 0 && search_count == 0) break;
+
+        const Dataset *ds = registry_open(paths[p]);
+        if (ds == NULL) {
+            failures++;
+            continue;
+        }
+        results_set_dataset(ds);
+        printf("\n--- Archivo: %s (%d elementos) ---\n", paths[p], ds->n);
+        failures += batch_run_dataset(ds, sorts, sort_count, searches, search_count, have_target ? &goal : NULL);
+    }
+
+    // the distribution x size matrix, every cell generated in memory and tagged with its distribution
+    for (int d = 0; d < dist_count && (sort_count > 0 || search_count > 0); d++) {
+        for (int k = 0; k < num_matrix; k++) {
+            Dataset ds;
+            if (distribution_generate(&ds, dists[d], matrix_sizes[k], matrix_seed) != 0) {
+                failures++;
+                continue;
             }
-            free(arr);
+            results_set_dataset(&ds);
+            result_context.distribution = dists[d]->key;
+            printf("\n--- Distribución: %s (%s) | %d elementos ---\n", dists[d]->name, dists[d]->key, ds.n);
+            failures += batch_run_dataset(&ds, sorts, sort_count, searches, search_count, have_target ? &goal : NULL);
+            dataset_close(&ds);
         }
     }
+
+    sorted_snapshot_release();
+    registry_close_all();
+    work_buffers_release();
+    pool_stop();
+    if ((sort_count > 0 || search_count > 0) && results_export() != 0) failures++;
+    results_close();
+    return failures == 0 ? 0 : EXIT_BENCH_FAILURE;
 }
 
-int main(void) {
-    menu();
-    return 0;
+int main(int argc, char **argv) {
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    config.threads = cpus < 1 ? 1 : (cpus > MAX_THREADS ? MAX_THREADS : (int)cpus);
+
+    if (argc == 1) {
+        pool_start(config.threads, config.pin_threads);
+        menu();
+        pool_stop();
+        return 0;
+    }
+    return run_batch(argc, argv);
 }
\ No newline at end of file
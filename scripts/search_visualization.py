@@ -11,6 +11,9 @@ def generate_search_chart(csv_file, output_file='images/search_results.png'):
         for row in reader:
             if len(row) >= 3:  # Asegurar que hay al menos 3 columnas
                 algorithm, size, time = row[0], int(row[1]), float(row[2])
+                # cada distribución de entrada es una serie propia
+                if len(row) >= 14 and row[13] not in ('', 'uniform'):
+                    algorithm = f"{algorithm} [{row[13]}]"
                 if algorithm not in algorithms:
                     algorithms[algorithm] = {'sizes': [], 'times': []}
                 algorithms[algorithm]['sizes'].append(size)